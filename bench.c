@@ -1,69 +1,204 @@
-
-#include <kos.h>
-
 #include <stdio.h>
 #include <stdlib.h>
-#include <assert.h>
-#include "memfuncs.h"
-#include "fastmem.h"
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "platform.h"
 
-#define SIZE 1024 * 4 //16+1
-#define ITERATIONS 1
+// Defaults for the options below. KallistiOS passes no arguments, so these
+// are also what the Dreamcast build runs.
+#define OPERATIONS "memset" // -o
+#define SIZES "lin:0:4095" // -s
+#define ALIGNS "0:0" // -a
+#define FORMAT "wide" // -f
 
-int main(int argc, char **argv)
+// Measurement engine settings, see bench.h
+#define WARMUP 2 // -w
+#define REPETITIONS 15 // -r
+#define OUTLIER_Z 3.5 // -z
+#define CACHE BENCH_CACHE_WARM // -c, or BENCH_CACHE_COLD, BENCH_CACHE_DST_COLD
+#define BATCH 0 // -b, calls per sample, 0 for automatic
+#define COUNTERS "none" // -e, hardware counter backend
+
+// Mode run when no mode is given:
+//   sweep              - the sizes, alignments, operations and implementations
+//                        selected with -s, -a, -o and -i
+//   align [offsets]    - src/dst misalignment matrix, offsets 0..offsets-1
+//   coalign [offsets]  - memcpy with src and dst sharing each offset
+//   overlap            - memmove overlap-distance sweep, both directions
+//   calibrate          - print memauto_table.h for this machine
+//   const              - constant-size inline copies/sets vs the runtime path
+//   unroll             - generated width x unroll kernels, fastest flagged
+//   cache              - every operation warm, cold and destination-cold
+//   large [max_kb]     - heap buffers up to max_kb KB, throughput in MB/s
+//   roofline [out_kb]  - read/write/copy peaks in and out of cache, kernels
+//                        as a percentage of peak
+//   latency [max_kb]   - print memfuncs_tuning.h (pointer-chase latency and
+//                        prefetch distance) for this machine
+//   replay [dist] [n]  - n calls drawn from a size distribution (a preset:
+//                        small, packets, textures, or a file), per family
+//   memcmp [max_kb]    - memcmp by size and position of the first difference
+//   strings [max_kb]   - strlen, memchr and strchr by length and match position
+//   verify [cases]     - check the kernels against libc on random calls
+#ifndef DEFAULT_MODE
+#define DEFAULT_MODE "sweep"
+#endif
+#define ALIGN_OFFSETS 8
+#define LARGE_MAX_KB 4096
+#define ROOFLINE_OUT_KB 1024
+#define LATENCY_MAX_KB 8192
+#define REPLAY_DISTRIBUTION "small"
+#define REPLAY_CALLS 1024
+#define MEMCMP_MAX_KB 16
+#define STRINGS_MAX_KB 16
+#define VERIFY_CASES 20000
+
+static void usage(const char *argv0)
 {
-    char src[SIZE]__attribute__((aligned(8)));
-    char dst[SIZE]__attribute__((aligned(8)));
+    fprintf(stderr,
+        "usage: %s [options] [mode [args]]\n"
+        "\n"
+        "modes: sweep | align [offsets] | coalign [offsets] | overlap | calibrate |\n"
+        "       const | unroll | cache | large [max_kb] | roofline [out_kb] |\n"
+        "       latency [max_kb] | replay [small|packets|textures|FILE] [calls] |\n"
+        "       memcmp [max_kb] | strings [max_kb] | verify [cases]\n"
+        "       (default " DEFAULT_MODE ")\n"
+        "\n"
+        "options (-f, -w, -r, -z, -c, -b and -e apply to every mode, the rest to sweep):\n"
+        "  -o OPS       memcpy,memmove,memset (default " OPERATIONS ")\n"
+        "  -i IMPLS     implementations by name or suffix, e.g. libc,moop,fast,auto\n"
+        "               (default all)\n"
+        "  -s SIZES     lin:START:END[:STEP] | log:START:END[:PER_DOUBLING] | A,B,...\n"
+        "               k/m suffixes allowed (default " SIZES ")\n"
+        "  -a ALIGNS    SRC:DST,... offsets below %d, N for N:N (default " ALIGNS ")\n"
+        "  -f FORMAT    wide | long | json, wide is long outside sweep (default " FORMAT ")\n"
+        "  -w N         untimed warmup calls (default %d)\n"
+        "  -r N         timed repetitions (default %d)\n"
+        "  -z Z         outlier modified z-score cutoff, 0 keeps all (default %.1f)\n"
+        "  -c CACHE     warm | cold | dst-cold (default %s)\n"
+        "  -b N         calls per timed sample, auto sizes it to %d ns (default %s)\n"
+        "  -e COUNTERS  hardware counters: perf | sh4 | auto | none (default " COUNTERS ")\n",
+        argv0, BENCH_MAX_ALIGN, WARMUP, REPETITIONS, OUTLIER_Z, bench_cache_name(CACHE),
+        BENCH_BATCH_TARGET_NS, BATCH ? "fixed" : "auto");
+}
 
-    srand((unsigned int)time(NULL));
+int main(int argc, char **argv)
+{
+    bench_config cfg = { WARMUP, REPETITIONS, OUTLIER_Z, CACHE, BATCH, NULL, 0, BENCH_FORMAT_WIDE };
+    bench_selection sel = { 0 };
+    const char *argv0 = argv[0];
+    const char *mode, *counters;
+    int opt, bad = 0;
 
-    int i, j;
+    platform_init();
 
-    printf("Bytes,Memmove,Memmove_Moop,Memmove_Fast\n"); // Header for CSV format
+    bad |= bench_parse_ops(OPERATIONS, &sel);
+    bad |= bench_parse_sizes(SIZES, &sel);
+    bad |= bench_parse_aligns(ALIGNS, &sel);
+    bad |= bench_parse_format(FORMAT, &cfg);
+    counters = COUNTERS;
 
-    for(j = 0; j < SIZE; j++)
+    while(!bad && (opt = getopt(argc, argv, "o:i:s:a:f:w:r:z:c:b:e:h")) != -1)
     {
-        // Initialize the source with some data
-        for (i = 0; i < j; i++) {
-            src[i] = rand() % 256;
-        }
-
-        uint64_t first_total = 0;
-        for(i = 0; i < ITERATIONS; ++i)
+        switch(opt)
         {
-            uint64_t start = timer_ns_gettime64();
-            memset(src,0,j);
-            first_total += (timer_ns_gettime64() - start);
-            assert(!memcmp(src, (char[SIZE]){0}, j));  
+            case 'o':
+                bad = bench_parse_ops(optarg, &sel);
+                break;
+            case 'i':
+                sel.impls = optarg;
+                break;
+            case 's':
+                bad = bench_parse_sizes(optarg, &sel) || !sel.size_count;
+                break;
+            case 'a':
+                bad = bench_parse_aligns(optarg, &sel);
+                break;
+            case 'f':
+                bad = bench_parse_format(optarg, &cfg);
+                break;
+            case 'w':
+                cfg.warmup = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                cfg.repetitions = (unsigned)atoi(optarg);
+                bad = !cfg.repetitions;
+                break;
+            case 'z':
+                cfg.outlier_z = atof(optarg);
+                break;
+            case 'c':
+                bad = bench_parse_cache(optarg, &cfg);
+                break;
+            case 'b':
+                cfg.batch = strcmp(optarg, "auto") ? (unsigned)atoi(optarg) : 0;
+                bad = cfg.batch > BENCH_BATCH_MAX;
+                break;
+            case 'e':
+                counters = optarg;
+                break;
+            default:
+                bad = 1;
+                break;
         }
 
-        for (i = 0; i < j; i++) {
-            src[i] = rand() % 256;
-        }
+        if(bad && opt != '?' && opt != 'h')
+            fprintf(stderr, "%s: bad argument to -%c: %s\n", argv0, opt, optarg);
+    }
 
-        uint64_t second_total = 0;
-        for(i = 0; i < ITERATIONS; ++i)
-        {
-            uint64_t start = timer_ns_gettime64();
-            memset_moop(src,0,j);
-            second_total += (timer_ns_gettime64() - start);
-            assert(!memcmp(src, (char[SIZE]){0}, j));  
-        }
+    if(bad)
+    {
+        usage(argv0);
+        return 1;
+    }
 
-        for (i = 0; i < j; i++) {
-            src[i] = rand() % 256;
-        }
+    if(strcmp(counters, "none"))
+    {
+        cfg.counters = counters_select(counters, &cfg.counter_events);
+        if(!cfg.counters)
+            return 1;
+    }
 
-        uint64_t third_total = 0;
-        for(i = 0; i < ITERATIONS; ++i)
-        {
-            uint64_t start = timer_ns_gettime64();
-            memset_fast(src,0,j);
-            third_total += (timer_ns_gettime64() - start);
-            assert(!memcmp(src, (char[SIZE]){0}, j));  
-        }
+    bench_timer_init();
+
+    mode = optind < argc ? argv[optind++] : DEFAULT_MODE;
+    argc -= optind;
+    argv += optind;
 
-        printf("%d,%llu,%llu,%llu\n", j, first_total, second_total, third_total);
+    if(!strcmp(mode, "sweep"))
+        bench_sweep(&cfg, &sel);
+    else if(!strcmp(mode, "align"))
+        bench_align_sweep(&cfg, argc > 0 ? (unsigned)atoi(argv[0]) : ALIGN_OFFSETS);
+    else if(!strcmp(mode, "coalign"))
+        bench_coalign_sweep(&cfg, argc > 0 ? (unsigned)atoi(argv[0]) : ALIGN_OFFSETS);
+    else if(!strcmp(mode, "overlap"))
+        bench_overlap_sweep(&cfg);
+    else if(!strcmp(mode, "calibrate"))
+        bench_calibrate(&cfg);
+    else if(!strcmp(mode, "const"))
+        bench_const_sweep(&cfg);
+    else if(!strcmp(mode, "unroll"))
+        bench_unroll_sweep(&cfg);
+    else if(!strcmp(mode, "cache"))
+        bench_cache_sweep(&cfg);
+    else if(!strcmp(mode, "large"))
+        bench_large_sweep(&cfg, (size_t)(argc > 0 ? (unsigned)atoi(argv[0]) : LARGE_MAX_KB) * 1024);
+    else if(!strcmp(mode, "roofline"))
+        bench_roofline(&cfg, (size_t)(argc > 0 ? (unsigned)atoi(argv[0]) : ROOFLINE_OUT_KB) * 1024);
+    else if(!strcmp(mode, "latency"))
+        bench_latency(&cfg, (size_t)(argc > 0 ? (unsigned)atoi(argv[0]) : LATENCY_MAX_KB) * 1024);
+    else if(!strcmp(mode, "replay"))
+        bench_replay(&cfg, argc > 0 ? argv[0] : REPLAY_DISTRIBUTION, argc > 1 ? (unsigned)atoi(argv[1]) : REPLAY_CALLS);
+    else if(!strcmp(mode, "memcmp"))
+        bench_memcmp(&cfg, (size_t)(argc > 0 ? (unsigned)atoi(argv[0]) : MEMCMP_MAX_KB) * 1024);
+    else if(!strcmp(mode, "strings"))
+        bench_strings(&cfg, (size_t)(argc > 0 ? (unsigned)atoi(argv[0]) : STRINGS_MAX_KB) * 1024);
+    else if(!strcmp(mode, "verify"))
+        return bench_verify(argc > 0 ? (unsigned)atoi(argv[0]) : VERIFY_CASES) ? 1 : 0;
+    else {
+        fprintf(stderr, "%s: unknown mode %s\n", argv0, mode);
+        usage(argv0);
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,279 @@
+//==============================================================================
+//  Benchmark Engine
+//==============================================================================
+//
+// Times one implementation of memcpy/memmove/memset at one size: a few untimed
+// warmup calls, then a number of timed repetitions. Each repetition times a
+// batch of back-to-back calls, enough to dwarf the timer's own cost, which is
+// measured once and subtracted. Each repetition gets fresh
+// random data and is checked against libc outside the timed region, and the
+// buffers are then left in the configured cache state. Samples
+// that are far above the median (interrupts, cache refills from other work)
+// are rejected before the statistics are computed.
+//
+
+#ifndef __BENCH_H_
+#define __BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "counters.h"
+
+// Bytes on either side of the destination that are checked for stray writes.
+// Buffers handed to bench_run() need this much slack around dst.
+#define BENCH_GUARD 32
+
+// Source/destination offsets the sweep accepts are below this (one cache line)
+#define BENCH_MAX_ALIGN 32
+
+// Automatic batches grow until one sample takes this long, or hit the cap
+#define BENCH_BATCH_TARGET_NS 10000
+#define BENCH_BATCH_MAX 4096
+
+// Batches whose hardware events are counted; the median of each event is kept
+#define BENCH_COUNTER_RUNS 5
+
+typedef enum {
+    BENCH_OP_MEMCPY,
+    BENCH_OP_MEMMOVE,
+    BENCH_OP_MEMSET,
+    BENCH_OP_READ, // loads only through copy(), dst must come back untouched
+    // Only names for results; their modes time them without bench_run()
+    BENCH_OP_MEMCMP,
+    BENCH_OP_STRLEN,
+    BENCH_OP_MEMCHR,
+    BENCH_OP_STRCHR,
+    BENCH_OP_REPLAY, // a stream of mixed calls
+} bench_op;
+
+typedef void * (*bench_copy_fn)(void *dest, const void *src, size_t n);
+typedef void * (*bench_set_fn)(void *dest, int c, size_t n);
+
+typedef struct {
+    const char *name; // CSV column label, e.g. "Memcpy_Moop"
+    bench_op op;
+    bench_copy_fn copy; // BENCH_OP_MEMCPY and BENCH_OP_MEMMOVE
+    bench_set_fn set; // BENCH_OP_MEMSET
+    int choice; // MEMAUTO_* id memauto can dispatch to, -1 for none
+} bench_impl;
+
+// Cache state of the buffers at the start of every timed call
+typedef enum {
+    BENCH_CACHE_WARM, // just written by the data refill, fully cache-hot
+    BENCH_CACHE_COLD, // source and destination purged to memory
+    BENCH_CACHE_DST_COLD, // destination purged, source read back in
+} bench_cache;
+
+typedef enum {
+    BENCH_FORMAT_WIDE, // one row per size, a column group per implementation
+    BENCH_FORMAT_LONG, // one CSV row per measurement
+    BENCH_FORMAT_JSON, // one JSON object per line per measurement
+} bench_format;
+
+typedef struct {
+    unsigned warmup; // untimed calls before sampling
+    unsigned repetitions; // timed samples per (implementation, size)
+    double outlier_z; // reject samples whose modified z-score exceeds this, 0 keeps all
+    bench_cache cache;
+    unsigned batch; // calls per timed sample, 0 picks one per (implementation, size)
+    const counter_backend *counters; // NULL for no hardware counters
+    unsigned counter_events; // what counters can count, see counters_select()
+    bench_format format; // only sweep has a wide layout, the other modes print it as long
+} bench_config;
+
+// Nanoseconds per call
+typedef struct {
+    double min;
+    double median;
+    double p99;
+    double max;
+    double mean;
+    double stddev;
+    double cycles; // median in CPU cycles, 0 if the clock rate is unknown
+    unsigned samples; // kept after outlier rejection
+    unsigned rejected;
+    unsigned batch; // calls per sample
+    double per_byte[COUNTER_EVENTS]; // hardware events per byte (per call at size 0)
+    unsigned counted; // bitmask of the per_byte entries that were measured
+} bench_stats;
+
+typedef struct {
+    unsigned src;
+    unsigned dst;
+} bench_align;
+
+// What the sweep mode runs, filled in from the command line
+typedef struct {
+    unsigned ops; // bitmask of 1 << bench_op
+    const char *impls; // comma-separated names, e.g. "libc,moop" or "Memcpy_Fast", NULL for all
+    size_t *sizes;
+    unsigned size_count;
+    bench_align *aligns;
+    unsigned align_count;
+} bench_selection;
+
+// One timed call: fn(dst, src, len) or fn(dst, val, len).
+// src may overlap dst for memmove.
+typedef struct {
+    uint8_t *dst;
+    const uint8_t *src;
+    size_t len;
+    int val;
+} bench_args;
+
+// Implementations of an operation, terminated by an entry with a NULL name.
+// The first entry is always libc.
+const bench_impl * bench_impls(bench_op op);
+
+// Lowercase operation name, e.g. "memcpy".
+const char * bench_op_name(bench_op op);
+
+// Cache state name as used in the CSV, e.g. "cold".
+const char * bench_cache_name(bench_cache cache);
+
+// Measure the timer's overhead and resolution. Call once after
+// platform_init() and before anything is timed.
+void bench_timer_init(void);
+
+// Warm up, time cfg->repetitions calls and fill in stats. With counters, also
+// runs BENCH_COUNTER_RUNS untimed batches per counter pass. Aborts if any call
+// produces a different result than libc.
+void bench_run(const bench_config *cfg, const bench_impl *impl, const bench_args *args, bench_stats *stats);
+
+// Runs count back-to-back calls of whatever a mode times, on the state ctx
+// points to. Modes whose calls don't fit bench_impl time through this.
+typedef void (*bench_batch_fn)(void *ctx, unsigned count);
+
+// Wall time of one run(ctx, count) in ns, less the timer overhead.
+double bench_time_batch(bench_batch_fn run, void *ctx, unsigned count);
+
+// bench_run() for a bench_batch_fn: warm up, size the batch the same way,
+// time cfg->repetitions batches into samples and fill in stats. Nothing is
+// refilled or checked between batches.
+void bench_measure(const bench_config *cfg, bench_batch_fn run, void *ctx, double *samples, bench_stats *stats);
+
+// Powers of two and the points halfway between them: 1, 2, 3, 4, 6, 8, ...
+size_t bench_next_size(size_t len);
+
+// Sorts samples in place, rejects outliers and computes the statistics.
+// Each sample is one batch of batch calls divided by batch.
+void bench_stats_compute(double *samples, unsigned count, unsigned batch, double outlier_z, bench_stats *stats);
+
+// 32-byte aligned heap block of len bytes. Aborts if there is no memory.
+// Free *raw, not the returned pointer.
+uint8_t * bench_alloc(size_t len, void **raw);
+
+// CSV helpers: "<name>_Min,<name>_Median,..." (or "Min,Median,..." when name
+// is NULL) and the matching values, each preceded by a comma.
+void bench_print_stats_header(const char *name);
+void bench_print_stats(const bench_stats *stats);
+
+// Columns a mode adds to the result schema. The first keys name what else
+// tells its rows apart (overlap distance, mismatch position) and go after
+// Cache, where membench-compare matches on them; the rest are figures derived
+// from the row (MB_s, Slowdown) and go after the hardware counters. Names are
+// set once, values per row with bench_extra_set().
+#define BENCH_EXTRA_MAX 4
+#define BENCH_EXTRA_LEN 64
+
+typedef struct {
+    unsigned keys;
+    unsigned count;
+    const char *names[BENCH_EXTRA_MAX];
+    char values[BENCH_EXTRA_MAX][BENCH_EXTRA_LEN];
+} bench_extra;
+
+void bench_extra_set(bench_extra *extra, unsigned i, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// One measurement in the long-format result schema (see bench_results.c):
+// a CSV header and rows for BENCH_FORMAT_LONG (and WIDE, which only sweep
+// lays out itself), JSON lines for BENCH_FORMAT_JSON. The header is empty for
+// JSON. extra may be NULL.
+void bench_result_header(bench_format format, const bench_extra *extra);
+void bench_result_print(bench_format format, const bench_config *cfg, bench_op op, const char *impl,
+    size_t len, const bench_align *align, const bench_stats *stats, const bench_extra *extra);
+
+// Command-line parsers, each returning 0 or -1 for a malformed spec.
+//
+// sizes: "lin:START:END[:STEP]", "log:START:END[:STEPS_PER_DOUBLING]" or a
+//        list "A,B,..." (optionally "list:A,B,..."), k/m suffixes allowed
+// aligns: "S:D,..." source:destination offset pairs, "N" for N:N
+// ops: "memcpy,memmove,memset"
+// format: "wide", "long" or "json"
+// cache: "warm", "cold" or "dst-cold"
+// size: one number (decimal or 0x hex), k/m suffix allowed, *end left after it
+int bench_parse_size(const char *s, char **end, size_t *out);
+
+int bench_parse_sizes(const char *spec, bench_selection *sel);
+int bench_parse_aligns(const char *spec, bench_selection *sel);
+int bench_parse_ops(const char *spec, bench_selection *sel);
+int bench_parse_format(const char *spec, bench_config *cfg);
+int bench_parse_cache(const char *spec, bench_config *cfg);
+
+// Whether sel->impls names impl, by full name, by the part after the
+// operation ("Moop") or as "libc", case-insensitively.
+int bench_impl_selected(const bench_selection *sel, const bench_impl *impl);
+
+// Suites
+//
+// Every selected operation, alignment, size and implementation.
+void bench_sweep(const bench_config *cfg, const bench_selection *sel);
+
+// Source/destination misalignment matrix: every (src, dst) offset pair in
+// 0..max_offset-1 for each operation, implementation and size. One row per
+// cell, in long format so it can be pivoted straight into a heatmap.
+void bench_align_sweep(const bench_config *cfg, unsigned max_offset);
+
+// Co-aligned memcpy: source and destination share the same offset 0..max_offset-1
+// (the diagonal of the alignment matrix), where memcpy_moop peels head bytes.
+void bench_coalign_sweep(const bench_config *cfg, unsigned max_offset);
+
+// memmove with source and destination in the same buffer, both directions,
+// at distances 1..64 and then powers of two up to twice the size.
+void bench_overlap_sweep(const bench_config *cfg);
+
+// Measures the fastest implementation per memauto size bucket and prints
+// memauto_table.h on stdout (progress goes to stderr).
+void bench_calibrate(const bench_config *cfg);
+
+// memfuncs_inline.h at constant sizes against libc and the runtime functions.
+void bench_const_sweep(const bench_config *cfg);
+
+// Every width x unroll kernel from memkernels.c for copy, move and set.
+void bench_unroll_sweep(const bench_config *cfg);
+
+// Every operation and implementation at sizes around the operand cache size,
+// once per cache state (cfg->cache is ignored).
+void bench_cache_sweep(const bench_config *cfg);
+
+// Every operation and implementation on heap buffers from 32 bytes to
+// max_size, log-spaced with dense sampling around the cache size, in MB/s.
+void bench_large_sweep(const bench_config *cfg, size_t max_size);
+
+// Read, write and copy loops at each access width in and out of cache, then
+// the library kernels as a percentage of the best loop for their operation.
+void bench_roofline(const bench_config *cfg, size_t out_size);
+
+// Pointer-chase load latency from 1 KB to max_size, printed as
+// memfuncs_tuning.h with the prefetch distance derived from it.
+void bench_latency(const bench_config *cfg, size_t max_size);
+
+// calls operations drawn from the distribution in the named preset or file
+// (format in bench_replay.c), timed as one stream per implementation family.
+void bench_replay(const bench_config *cfg, const char *name, unsigned calls);
+
+// memcmp_moop against libc from 1 byte to max_size, with the buffers equal
+// and with the first difference at the start, middle and end.
+void bench_memcmp(const bench_config *cfg, size_t max_size);
+
+// strlen_moop, memchr_moop and strchr_moop against libc from 1 byte to
+// max_size, with no match and with the match at the start, middle and end.
+void bench_strings(const bench_config *cfg, size_t max_size);
+
+// Checks the kernels and *_moop functions against libc on cases random calls
+// each (see bench_verify.c). Returns the number of failed calls.
+unsigned bench_verify(unsigned cases);
+
+#endif /* __BENCH_H_ */
@@ -0,0 +1,103 @@
+// Source/destination alignment sweep
+//
+// memcpy_moop and friends pick their kernel from (src | dest) & 7, so a single
+// misaligned byte can send a large copy down the byte-at-a-time path. This
+// suite times every offset pair so those cliffs show up as a heatmap.
+
+#include <stdio.h>
+
+#include "bench.h"
+
+#define ALIGN_MAX_OFFSET 32 // one SH4 operand cache line
+#define ALIGN_MAX_SIZE 4096
+
+static const size_t align_sizes[] = { 8, 16, 32, 64, 128, 256, 512, 1024, 4096 };
+
+static uint8_t src_buf[ALIGN_MAX_SIZE + ALIGN_MAX_OFFSET]__attribute__((aligned(32)));
+static uint8_t dst_buf[ALIGN_MAX_SIZE + ALIGN_MAX_OFFSET + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+static const bench_op align_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+void bench_align_sweep(const bench_config *cfg, unsigned max_offset) {
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align;
+    bench_extra extra = { 0, 1, { "Slowdown" } }; // median relative to the (0, 0) cell
+    unsigned o, i, s, d;
+
+    if(max_offset > ALIGN_MAX_OFFSET)
+        max_offset = ALIGN_MAX_OFFSET;
+
+    bench_result_header(cfg->format, &extra);
+
+    args.val = 0x5a;
+
+    for(o = 0; o < sizeof(align_ops) / sizeof(align_ops[0]); o++) {
+        bench_op op = align_ops[o];
+        // memset has no source, so only its destination offset is swept
+        unsigned src_offsets = op == BENCH_OP_MEMSET ? 1 : max_offset;
+
+        for(i = 0; i < sizeof(align_sizes) / sizeof(align_sizes[0]); i++) {
+            args.len = align_sizes[i];
+
+            for(impl = bench_impls(op); impl->name; impl++) {
+                double aligned_median = 0;
+
+                for(s = 0; s < src_offsets; s++) {
+                    for(d = 0; d < max_offset; d++) {
+                        args.src = src_buf + s;
+                        args.dst = dst_buf + BENCH_GUARD + d;
+
+                        bench_run(cfg, impl, &args, &stats);
+
+                        if(!s && !d)
+                            aligned_median = stats.median > 0 ? stats.median : 1;
+
+                        align.src = s;
+                        align.dst = d;
+                        bench_extra_set(&extra, 0, "%.2f", stats.median / aligned_median);
+                        bench_result_print(cfg->format, cfg, op, impl->name, args.len, &align, &stats, &extra);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void bench_coalign_sweep(const bench_config *cfg, unsigned max_offset) {
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align;
+    bench_extra extra = { 0, 1, { "Slowdown" } }; // median relative to offset 0
+    unsigned i, k;
+
+    if(max_offset > ALIGN_MAX_OFFSET)
+        max_offset = ALIGN_MAX_OFFSET;
+
+    bench_result_header(cfg->format, &extra);
+
+    for(i = 0; i < sizeof(align_sizes) / sizeof(align_sizes[0]); i++) {
+        args.len = align_sizes[i];
+
+        for(impl = bench_impls(BENCH_OP_MEMCPY); impl->name; impl++) {
+            double aligned_median = 0;
+
+            for(k = 0; k < max_offset; k++) {
+                args.src = src_buf + k;
+                args.dst = dst_buf + BENCH_GUARD + k;
+
+                bench_run(cfg, impl, &args, &stats);
+
+                if(!k)
+                    aligned_median = stats.median > 0 ? stats.median : 1;
+
+                align.src = align.dst = k;
+                bench_extra_set(&extra, 0, "%.2f", stats.median / aligned_median);
+                bench_result_print(cfg->format, cfg, BENCH_OP_MEMCPY, impl->name, args.len, &align, &stats,
+                    &extra);
+            }
+        }
+    }
+}
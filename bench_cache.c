@@ -0,0 +1,66 @@
+// Cold vs warm cache sweep
+//
+// Every other suite times calls on buffers the refill has just written, so
+// they measure the pipeline with everything in the operand cache. Here each
+// operation and implementation is timed three times per size: warm, with both
+// buffers purged to memory, and with only the destination purged (the usual
+// case of copying freshly produced data into a buffer that hasn't been
+// touched this frame). Sizes go past the 16 KB operand cache.
+
+#include <stdio.h>
+
+#include "bench.h"
+
+#define CACHE_MAX_SIZE 65536
+
+static const size_t cache_sizes[] = { 64, 512, 4096, 16384, 65536 };
+
+static const bench_op cache_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+static const bench_cache cache_states[] = { BENCH_CACHE_WARM, BENCH_CACHE_COLD, BENCH_CACHE_DST_COLD };
+
+static uint8_t src_buf[CACHE_MAX_SIZE]__attribute__((aligned(32)));
+static uint8_t dst_buf[CACHE_MAX_SIZE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+void bench_cache_sweep(const bench_config *cfg) {
+    bench_config state_cfg = *cfg;
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align = { 0, 0 };
+    bench_extra extra = { 0, 1, { "Slowdown" } }; // median relative to the warm row
+    unsigned o, i, c;
+
+    bench_result_header(cfg->format, &extra);
+
+    args.src = src_buf;
+    args.dst = dst_buf + BENCH_GUARD;
+    args.val = 0x5a;
+
+    for(o = 0; o < sizeof(cache_ops) / sizeof(cache_ops[0]); o++) {
+        bench_op op = cache_ops[o];
+
+        for(i = 0; i < sizeof(cache_sizes) / sizeof(cache_sizes[0]); i++) {
+            args.len = cache_sizes[i];
+
+            for(impl = bench_impls(op); impl->name; impl++) {
+                double warm_median = 1;
+
+                for(c = 0; c < sizeof(cache_states) / sizeof(cache_states[0]); c++) {
+                    // memset has no source, so dst-cold is the same as cold
+                    if(op == BENCH_OP_MEMSET && cache_states[c] == BENCH_CACHE_DST_COLD)
+                        continue;
+
+                    state_cfg.cache = cache_states[c];
+                    bench_run(&state_cfg, impl, &args, &stats);
+
+                    if(cache_states[c] == BENCH_CACHE_WARM)
+                        warm_median = stats.median > 0 ? stats.median : 1;
+
+                    bench_extra_set(&extra, 0, "%.2f", stats.median / warm_median);
+                    bench_result_print(cfg->format, &state_cfg, op, impl->name, args.len, &align, &stats, &extra);
+                }
+            }
+        }
+    }
+}
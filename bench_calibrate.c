@@ -0,0 +1,121 @@
+// memauto calibration
+//
+// Times every implementation that memauto can dispatch to at the bottom,
+// middle and top of each size bucket, picks the one with the lowest total
+// median per bucket, and prints the result as memauto_table.h on stdout.
+// Buckets above CALIBRATE_MAX_BUCKET reuse the last measured choice.
+//
+// memmove_moop hands disjoint ranges to memcpy_moop, so memmove is timed on
+// overlapping ones instead: within one buffer, moving forwards and backwards
+// by CALIBRATE_MOVE_DISTANCE bytes, or half the size when that is smaller.
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "memauto.h"
+#include "platform.h"
+
+#define CALIBRATE_MAX_BUCKET 16 // sizes up to 64 KB
+#define CALIBRATE_MAX_SIZE (1 << CALIBRATE_MAX_BUCKET)
+#define CALIBRATE_MOVE_DISTANCE 8 // keeps the 64-bit kernels in play
+
+static uint8_t src_buf[CALIBRATE_MAX_SIZE]__attribute__((aligned(32)));
+static uint8_t dst_buf[CALIBRATE_MAX_SIZE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+static uint8_t move_buf[CALIBRATE_MAX_SIZE + CALIBRATE_MOVE_DISTANCE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+static const bench_op calibrate_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+static const char * const choice_names[] = { "MEMAUTO_LIBC", "MEMAUTO_MOOP", "MEMAUTO_FAST" };
+
+// Total median time of impl over sizes at the bottom, middle and top of bucket
+static double bucket_cost(const bench_config *cfg, const bench_impl *impl, unsigned bucket) {
+    size_t lo = bucket ? (size_t)1 << (bucket - 1) : 0;
+    size_t sizes[3] = { lo, lo + lo / 2, 2 * lo - 1 };
+    unsigned count = bucket > 1 ? 3 : 1;
+    double total = 0;
+    bench_args args;
+    bench_stats stats;
+    unsigned i;
+
+    args.src = src_buf;
+    args.dst = dst_buf + BENCH_GUARD;
+    args.val = 0;
+
+    for(i = 0; i < count; i++) {
+        args.len = sizes[i];
+
+        if(impl->op == BENCH_OP_MEMMOVE) {
+            size_t distance = args.len / 2 < CALIBRATE_MOVE_DISTANCE ? args.len / 2 : CALIBRATE_MOVE_DISTANCE;
+            uint8_t *base = move_buf + BENCH_GUARD;
+
+            if(!distance)
+                distance = 1;
+
+            // Forwards (destination below the source), then backwards
+            args.src = base + distance;
+            args.dst = base;
+            bench_run(cfg, impl, &args, &stats);
+            total += stats.median;
+
+            args.src = base;
+            args.dst = base + distance;
+        }
+
+        bench_run(cfg, impl, &args, &stats);
+        total += stats.median;
+    }
+
+    return total;
+}
+
+void bench_calibrate(const bench_config *cfg) {
+    unsigned o, k;
+
+    printf("// Generated by \"membench calibrate\" on %s. Rerun it on the target\n", platform_name());
+    printf("// machine instead of editing this file by hand.\n");
+    printf("//\n");
+    printf("// One entry per memauto_bucket(): entry 0 is size 0, entry k covers\n");
+    printf("// [2^(k-1), 2^k) bytes and the last entry everything larger.\n");
+    printf("\n");
+    printf("#ifndef __MEMAUTO_TABLE_H_\n");
+    printf("#define __MEMAUTO_TABLE_H_\n");
+
+    for(o = 0; o < sizeof(calibrate_ops) / sizeof(calibrate_ops[0]); o++) {
+        bench_op op = calibrate_ops[o];
+        const char *name = bench_op_name(op);
+        int choice[MEMAUTO_BUCKETS];
+
+        for(k = 0; k < MEMAUTO_BUCKETS; k++) {
+            const bench_impl *impl;
+            double best_cost = 0;
+
+            if(k > CALIBRATE_MAX_BUCKET) {
+                choice[k] = choice[k - 1];
+                continue;
+            }
+
+            choice[k] = MEMAUTO_LIBC;
+            for(impl = bench_impls(op); impl->name; impl++) {
+                if(impl->choice < 0)
+                    continue;
+
+                double cost = bucket_cost(cfg, impl, k);
+                if(impl == bench_impls(op) || cost < best_cost) {
+                    best_cost = cost;
+                    choice[k] = impl->choice;
+                }
+            }
+
+            fprintf(stderr, "calibrate: %s bucket %u -> %s\n", name, k, choice_names[choice[k]]);
+        }
+
+        printf("\n#define MEMAUTO_");
+        for(; *name; name++)
+            putchar(*name - 'a' + 'A');
+        printf("_TABLE { \\\n");
+        for(k = 0; k < MEMAUTO_BUCKETS; k++)
+            printf("    %s,%s\n", choice_names[choice[k]], k + 1 < MEMAUTO_BUCKETS ? " \\" : " \\\n}");
+    }
+
+    printf("\n#endif /* __MEMAUTO_TABLE_H_ */\n");
+}
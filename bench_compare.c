@@ -0,0 +1,703 @@
+// Result comparator
+//
+//   membench-compare [-t PCT] [-a ALPHA] [-o OP] BASELINE... -- CANDIDATE...
+//   membench-compare [-t PCT] [-a ALPHA] [-o OP] BASELINE CANDIDATE
+//
+// Host-side tool, not part of membench itself. Reads result files, one run of
+// membench each, matches rows on operation, implementation, size, alignment,
+// cache state and the mode's key columns (the Variant, e.g.
+// "direction=forward;distance=8" for overlap), and compares them per log2 size
+// bucket (the memauto buckets: 0, then [2^(k-1), 2^k)). Accepted formats,
+// detected per file:
+//
+//   long CSV    -f long, the schema in bench_results.c (or the older
+//               Operation,Implementation,Bytes,... columns without units)
+//   JSON lines  -f json
+//   wide CSV    a Bytes column plus either one plain column per
+//               implementation (membench.csv) or -f wide's <Impl>_Median
+//               columns. The operation is taken from the implementation
+//               name, alignment is 0:0 and the cache warm. -o OP relabels
+//               the plain columns as OP, for files whose headers don't name
+//               what was timed (the first bench printed memset under
+//               Memmove).
+//
+// Only sizes present in every run on both sides are used. Each run gets the
+// mean log median over the sizes in the bucket, and the bucket's ratio is the
+// exponent of the difference of the candidate and baseline averages of those,
+// i.e. a geometric mean.
+//
+// The spread within a run says little about how much the next run moves
+// (placement, frequency and cache state change between processes), so the
+// test is on the runs themselves: with two or more runs per side, Welch's t
+// on the per-run bucket means, and a bucket is "slower" if its ratio is above
+// 1 + PCT/100 (default 5) and p is below ALPHA (default 0.01), "faster"
+// likewise. With a single run on either side there is nothing to estimate the
+// noise from, so the P_Value is left empty and a bucket past the threshold is
+// only "untested": two runs of the same binary can differ by more than PCT.
+//
+// Prints one CSV row per bucket and exits with 1 if any bucket is slower, so it
+// can gate a kernel change against a baseline, and 2 on errors.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <unistd.h>
+
+#define COMPARE_LINE_MAX 65536
+#define COMPARE_FIELDS_MAX 1024
+#define COMPARE_NAME_MAX 64
+#define COMPARE_RUNS_MAX 32
+#define COMPARE_VARIANT_MAX 256
+
+typedef struct {
+    char op[COMPARE_NAME_MAX];
+    char impl[COMPARE_NAME_MAX];
+    char cache[COMPARE_NAME_MAX];
+    char variant[COMPARE_VARIANT_MAX]; // key=value;... of the mode's key columns
+    unsigned bytes;
+    unsigned src_align;
+    unsigned dst_align;
+    double median;
+    unsigned side; // 0 baseline, 1 candidate
+    unsigned run; // file on that side
+} compare_row;
+
+typedef struct {
+    compare_row *rows;
+    unsigned count;
+    unsigned cap;
+} compare_set;
+
+static const char *argv0;
+static const char *wide_op; // -o, NULL to take the operation from the header
+
+static compare_row * add_row(compare_set *set) {
+    if(set->count == set->cap) {
+        compare_row *grown = realloc(set->rows, (set->cap ? 2 * set->cap : 256) * sizeof(compare_row));
+
+        if(!grown) {
+            fprintf(stderr, "%s: out of memory\n", argv0);
+            exit(2);
+        }
+
+        set->rows = grown;
+        set->cap = set->cap ? 2 * set->cap : 256;
+    }
+
+    memset(&set->rows[set->count], 0, sizeof(compare_row));
+    strcpy(set->rows[set->count].cache, "warm");
+    return &set->rows[set->count++];
+}
+
+static void copy_name(char *dst, const char *src) {
+    snprintf(dst, COMPARE_NAME_MAX, "%s", src);
+}
+
+// Splits a CSV line in place, unquoting "..." fields. Returns the field count.
+static unsigned split_csv(char *line, char **fields) {
+    unsigned count = 0;
+    char *out;
+
+    line[strcspn(line, "\r\n")] = '\0';
+
+    while(count < COMPARE_FIELDS_MAX) {
+        fields[count++] = out = line;
+
+        if(*line == '"') {
+            for(line++; *line; line++) {
+                if(*line == '"' && line[1] != '"')
+                    break;
+                if(*line == '"')
+                    line++;
+                *out++ = *line;
+            }
+            if(*line)
+                line++;
+        }
+        else {
+            while(*line && *line != ',')
+                *out++ = *line++;
+        }
+
+        if(*line != ',') {
+            *out = '\0';
+            break;
+        }
+
+        line++;
+        *out = '\0';
+    }
+
+    return count;
+}
+
+// Column of the first of names present in the header, -1 if none is
+static int column(char **header, unsigned count, const char *names) {
+    char buf[256], *name;
+    unsigned i;
+
+    snprintf(buf, sizeof(buf), "%s", names);
+    for(name = strtok(buf, "|"); name; name = strtok(NULL, "|")) {
+        for(i = 0; i < count; i++) {
+            if(!strcmp(header[i], name))
+                return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+static double number(char **fields, unsigned count, int col) {
+    return col >= 0 && (unsigned)col < count && *fields[col] ? strtod(fields[col], NULL) : 0.0;
+}
+
+static const char * text(char **fields, unsigned count, int col, const char *missing) {
+    return col >= 0 && (unsigned)col < count ? fields[col] : missing;
+}
+
+// Appends key=value to a variant, ';'-separated, with the key in lower case
+static void add_variant(char *variant, const char *key, size_t key_len, const char *value, size_t value_len) {
+    size_t len = strlen(variant);
+    char *c;
+
+    snprintf(variant + len, COMPARE_VARIANT_MAX - len, "%s%.*s=%.*s", len ? ";" : "", (int)key_len, key,
+        (int)value_len, value);
+    for(c = variant + len; *c && *c != '='; c++)
+        *c = (char)tolower((unsigned char)*c);
+}
+
+static void read_long(FILE *f, char **header, unsigned header_count, compare_set *set) {
+    int op = column(header, header_count, "Operation");
+    int impl = column(header, header_count, "Implementation");
+    int bytes = column(header, header_count, "Bytes");
+    int src = column(header, header_count, "Src_Align");
+    int dst = column(header, header_count, "Dst_Align");
+    int cache = column(header, header_count, "Cache");
+    int warmup = column(header, header_count, "Warmup");
+    int median = column(header, header_count, "Median_Ns|Median");
+    static char line[COMPARE_LINE_MAX];
+    char *fields[COMPARE_FIELDS_MAX];
+    unsigned count;
+    int k;
+
+    if(impl < 0 || bytes < 0 || median < 0) {
+        fprintf(stderr, "%s: long CSV without Implementation, Bytes or Median columns\n", argv0);
+        exit(2);
+    }
+
+    while(fgets(line, sizeof(line), f)) {
+        compare_row *row;
+
+        count = split_csv(line, fields);
+        if(count < 2)
+            continue;
+
+        row = add_row(set);
+        copy_name(row->op, text(fields, count, op, "?"));
+        copy_name(row->impl, text(fields, count, impl, "?"));
+        if(cache >= 0)
+            copy_name(row->cache, text(fields, count, cache, "warm"));
+        row->bytes = (unsigned)number(fields, count, bytes);
+        row->src_align = (unsigned)number(fields, count, src);
+        row->dst_align = (unsigned)number(fields, count, dst);
+        row->median = number(fields, count, median);
+
+        // Mode key columns sit between Cache and Warmup
+        for(k = cache + 1; cache >= 0 && k < warmup && (unsigned)k < count; k++)
+            add_variant(row->variant, header[k], strlen(header[k]), fields[k], strlen(fields[k]));
+    }
+}
+
+// Implementation whose median is in this column: 1 for <Impl>_Median, 2 for a
+// plain per-implementation column, 0 if it holds another stat
+static int wide_column(const char *name, char *impl) {
+    static const char * const skip[] = { "_Min", "_Mean", "_P99", "_Stddev", "_Cycles", "_Batch", "_Per_Byte" };
+    size_t len = strlen(name), n = strlen("_Median");
+    unsigned i;
+
+    if(len > n && !strcmp(name + len - n, "_Median")) {
+        snprintf(impl, COMPARE_NAME_MAX, "%.*s", (int)(len - n), name);
+        return 1;
+    }
+
+    for(i = 0; i < sizeof(skip) / sizeof(skip[0]); i++) {
+        n = strlen(skip[i]);
+        if(len > n && !strcmp(name + len - n, skip[i]))
+            return 0;
+    }
+
+    copy_name(impl, name);
+    return 2;
+}
+
+static void read_wide(FILE *f, char *first, compare_set *set) {
+    static char header_line[COMPARE_LINE_MAX], line[COMPARE_LINE_MAX];
+    char *header[COMPARE_FIELDS_MAX], *fields[COMPARE_FIELDS_MAX];
+    unsigned header_count, count, i;
+
+    snprintf(header_line, sizeof(header_line), "%s", first);
+    header_count = split_csv(header_line, header);
+
+    while(fgets(line, sizeof(line), f)) {
+        if(!strncmp(line, "Bytes,", 6)) {
+            snprintf(header_line, sizeof(header_line), "%s", line);
+            header_count = split_csv(header_line, header);
+            continue;
+        }
+
+        count = split_csv(line, fields);
+        if(count < 2 || !isdigit((unsigned char)*fields[0]))
+            continue;
+
+        for(i = 1; i < header_count && i < count; i++) {
+            char impl[COMPARE_NAME_MAX];
+            compare_row *row;
+            char *c;
+            int kind = wide_column(header[i], impl);
+
+            if(!kind)
+                continue;
+
+            row = add_row(set);
+            if(wide_op && kind == 2) {
+                const char *suffix = strchr(impl, '_');
+
+                copy_name(row->op, wide_op);
+                snprintf(row->impl, COMPARE_NAME_MAX, "%c%s%s", toupper((unsigned char)*wide_op), wide_op + 1,
+                    suffix ? suffix : "");
+            }
+            else {
+                copy_name(row->impl, impl);
+                copy_name(row->op, impl);
+                for(c = row->op; *c && *c != '_'; c++)
+                    *c = (char)tolower((unsigned char)*c);
+                *c = '\0';
+            }
+            row->bytes = (unsigned)strtoul(fields[0], NULL, 10);
+            row->median = number(fields, count, (int)i);
+        }
+    }
+}
+
+// Flat objects as bench_results.c writes them, nothing more general
+static const char * json_value(const char *line, const char *key) {
+    char pattern[COMPARE_NAME_MAX + 4];
+    const char *p;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    p = strstr(line, pattern);
+    return p ? p + strlen(pattern) : NULL;
+}
+
+static double json_number(const char *line, const char *keys) {
+    char buf[128], *key;
+
+    snprintf(buf, sizeof(buf), "%s", keys);
+    for(key = strtok(buf, "|"); key; key = strtok(NULL, "|")) {
+        const char *v = json_value(line, key);
+
+        if(v)
+            return strtod(v, NULL);
+    }
+
+    return 0.0;
+}
+
+static void json_string(const char *line, const char *keys, char *out) {
+    char buf[128], *key;
+
+    snprintf(buf, sizeof(buf), "%s", keys);
+    for(key = strtok(buf, "|"); key; key = strtok(NULL, "|")) {
+        const char *v = json_value(line, key);
+        size_t len;
+
+        if(!v || *v != '"')
+            continue;
+
+        len = strcspn(v + 1, "\"");
+        snprintf(out, COMPARE_NAME_MAX, "%.*s", (int)len, v + 1);
+        return;
+    }
+}
+
+// The members between "cache" and "warmup" are the mode's keys, all strings
+static void json_variant(const char *line, char *variant) {
+    const char *p = json_value(line, "cache"), *end = strstr(line, ",\"warmup\":");
+
+    if(!p || !end || *p != '"' || !(p = strchr(p + 1, '"')))
+        return;
+
+    for(p++; p < end && !strncmp(p, ",\"", 2); ) {
+        const char *key = p + 2, *value;
+        size_t key_len = strcspn(key, "\""), value_len;
+
+        value = key + key_len;
+        if(strncmp(value, "\":\"", 3))
+            return;
+        value += 3;
+
+        for(value_len = 0; value[value_len] && value[value_len] != '"'; value_len++) {
+            if(value[value_len] == '\\' && value[value_len + 1])
+                value_len++;
+        }
+
+        add_variant(variant, key, key_len, value, value_len);
+        p = value + value_len + 1;
+    }
+}
+
+static void read_json(FILE *f, const char *first, compare_set *set) {
+    static char line[COMPARE_LINE_MAX];
+    const char *l = first;
+
+    do {
+        compare_row *row;
+
+        if(*l != '{')
+            continue;
+
+        row = add_row(set);
+        strcpy(row->op, "?");
+        strcpy(row->impl, "?");
+        json_string(l, "operation|op", row->op);
+        json_string(l, "implementation|impl", row->impl);
+        json_string(l, "cache", row->cache);
+        json_variant(l, row->variant);
+        row->bytes = (unsigned)json_number(l, "bytes");
+        row->src_align = (unsigned)json_number(l, "src_align");
+        row->dst_align = (unsigned)json_number(l, "dst_align");
+        row->median = json_number(l, "median_ns|median");
+    } while((l = fgets(line, sizeof(line), f)));
+}
+
+static void read_results(const char *path, compare_set *set, unsigned side, unsigned run) {
+    static char first[COMPARE_LINE_MAX];
+    char *header[COMPARE_FIELDS_MAX];
+    unsigned count, start = set->count;
+    FILE *f = fopen(path, "r");
+
+    if(!f) {
+        fprintf(stderr, "%s: can't open %s\n", argv0, path);
+        exit(2);
+    }
+
+    // Skip leading blank lines
+    do {
+        if(!fgets(first, sizeof(first), f)) {
+            fprintf(stderr, "%s: %s is empty\n", argv0, path);
+            exit(2);
+        }
+    } while(first[strspn(first, " \t\r\n")] == '\0');
+
+    if(*first == '{')
+        read_json(f, first, set);
+    else if(!strncmp(first, "Bytes,", 6))
+        read_wide(f, first, set);
+    else {
+        count = split_csv(first, header);
+        read_long(f, header, count, set);
+    }
+
+    for(count = start; count < set->count; count++) {
+        set->rows[count].side = side;
+        set->rows[count].run = run;
+    }
+
+    fclose(f);
+}
+
+static int compare_key(const compare_row *a, const compare_row *b) {
+    int c;
+
+    if((c = strcmp(a->op, b->op)) || (c = strcmp(a->impl, b->impl)) || (c = strcmp(a->cache, b->cache))
+        || (c = strcmp(a->variant, b->variant)))
+        return c;
+    if(a->src_align != b->src_align)
+        return a->src_align < b->src_align ? -1 : 1;
+    if(a->dst_align != b->dst_align)
+        return a->dst_align < b->dst_align ? -1 : 1;
+
+    return 0;
+}
+
+// By key, then size, then side and run, so that each size's rows from every
+// run are next to each other
+static int compare_rows(const void *a, const void *b) {
+    const compare_row *x = a, *y = b;
+    int c = compare_key(x, y);
+
+    if(c)
+        return c;
+    if(x->bytes != y->bytes)
+        return x->bytes < y->bytes ? -1 : 1;
+    if(x->side != y->side)
+        return x->side < y->side ? -1 : 1;
+
+    return (x->run > y->run) - (x->run < y->run);
+}
+
+static unsigned bucket_of(unsigned bytes) {
+    unsigned k = 0;
+
+    while(bytes) {
+        bytes >>= 1;
+        k++;
+    }
+
+    return k;
+}
+
+// Regularized incomplete beta function I_x(a, b), by its continued fraction
+// (modified Lentz)
+static double incomplete_beta(double x, double a, double b) {
+    double front, c = 1.0, d, f, num;
+    unsigned i, m;
+
+    if(x <= 0)
+        return 0.0;
+    if(x >= 1)
+        return 1.0;
+
+    // The fraction converges quickly only below the mean
+    if(x > (a + 1) / (a + b + 2))
+        return 1.0 - incomplete_beta(1.0 - x, b, a);
+
+    front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x)) / a;
+
+    // The first term, -(a + b) x / (a + 1), starts the fraction
+    d = 1.0 - (a + b) * x / (a + 1);
+    d = fabs(d) < 1e-300 ? 1e300 : 1.0 / d;
+    f = d;
+
+    for(i = 2; i < 300; i++) {
+        m = i / 2;
+        num = i & 1 ? -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))
+            : m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+
+        d = 1.0 + num * d;
+        d = fabs(d) < 1e-300 ? 1e300 : 1.0 / d;
+        c = 1.0 + num / c;
+        c = fabs(c) < 1e-300 ? 1e-300 : c;
+        f *= c * d;
+
+        if(fabs(c * d - 1.0) < 1e-12)
+            break;
+    }
+
+    return front * f;
+}
+
+// Two-sided p-value of Student's t with df degrees of freedom
+static double student_p(double t, double df) {
+    return incomplete_beta(df / (df + t * t), df / 2, 0.5);
+}
+
+typedef struct {
+    const compare_row *key;
+    unsigned bucket;
+    unsigned sizes;
+    double log_sum[2][COMPARE_RUNS_MAX]; // per run, over the sizes
+} compare_bucket;
+
+// Adds the rows of one size, rows[0..count-1], to the bucket if every run has
+// it. Returns 1 if it was used.
+static int add_size(compare_bucket *b, const compare_row *rows, unsigned count, const unsigned *runs) {
+    double log_median[2][COMPARE_RUNS_MAX];
+    unsigned have[2][COMPARE_RUNS_MAX];
+    unsigned i, s, r;
+
+    memset(have, 0, sizeof(have));
+
+    // A run with the size twice (wide blocks lose the alignment) gets the
+    // first one
+    for(i = 0; i < count; i++) {
+        if(rows[i].median <= 0 || have[rows[i].side][rows[i].run])
+            continue;
+
+        log_median[rows[i].side][rows[i].run] = log(rows[i].median);
+        have[rows[i].side][rows[i].run] = 1;
+    }
+
+    for(s = 0; s < 2; s++) {
+        for(r = 0; r < runs[s]; r++) {
+            if(!have[s][r])
+                return 0;
+        }
+    }
+
+    for(s = 0; s < 2; s++) {
+        for(r = 0; r < runs[s]; r++)
+            b->log_sum[s][r] += log_median[s][r];
+    }
+
+    b->sizes++;
+    return 1;
+}
+
+// Prints the bucket, returns 1 if it is a slowdown
+static int finish_bucket(const compare_bucket *b, const unsigned *runs, double threshold, double alpha) {
+    unsigned lo = b->bucket ? 1u << (b->bucket - 1) : 0;
+    unsigned hi = b->bucket ? (1u << (b->bucket - 1)) * 2 - 1 : 0;
+    const char *verdict = "same";
+    double mean[2], var[2], ratio, p = 0;
+    unsigned s, r;
+    int tested = runs[0] >= 2 && runs[1] >= 2;
+
+    if(!b->sizes)
+        return 0;
+
+    // Mean and variance of the runs' bucket means on each side
+    for(s = 0; s < 2; s++) {
+        mean[s] = var[s] = 0;
+
+        for(r = 0; r < runs[s]; r++)
+            mean[s] += b->log_sum[s][r] / b->sizes;
+        mean[s] /= runs[s];
+
+        for(r = 0; r < runs[s]; r++) {
+            double d = b->log_sum[s][r] / b->sizes - mean[s];
+
+            var[s] += d * d;
+        }
+        var[s] = runs[s] > 1 ? var[s] / (runs[s] - 1) : 0;
+    }
+
+    ratio = exp(mean[1] - mean[0]);
+
+    if(tested) {
+        double v0 = var[0] / runs[0], v1 = var[1] / runs[1], se = sqrt(v0 + v1);
+
+        if(se > 0) {
+            double df = (v0 + v1) * (v0 + v1) / (v0 * v0 / (runs[0] - 1) + v1 * v1 / (runs[1] - 1));
+
+            p = student_p((mean[1] - mean[0]) / se, df);
+        }
+        else
+            p = mean[1] == mean[0] ? 1.0 : 0.0;
+    }
+
+    if(ratio > 1 + threshold || ratio < 1 / (1 + threshold)) {
+        if(!tested)
+            verdict = "untested";
+        else if(p < alpha)
+            verdict = ratio > 1 ? "slower" : "faster";
+    }
+
+    printf("%s,%s,%u,%u,%s,%s,%u,%u,%u,%.4f,", b->key->op, b->key->impl, b->key->src_align, b->key->dst_align,
+        b->key->cache, b->key->variant, lo, hi, b->sizes, ratio);
+    if(tested)
+        printf("%.3g", p);
+    printf(",%s,%s\n", tested ? "welch" : "ratio", verdict);
+
+    return verdict[0] == 's' && verdict[1] == 'l';
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: %s [-t PCT] [-a ALPHA] [-o OP] BASELINE... -- CANDIDATE...\n"
+        "       %s [-t PCT] [-a ALPHA] [-o OP] BASELINE CANDIDATE\n"
+        "  -t PCT     smallest slowdown or speedup reported, in percent (default 5)\n"
+        "  -a ALPHA   significance level with two or more runs per side (default 0.01)\n"
+        "  -o OP      operation of the rows in wide CSV files, e.g. memset\n", argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+    compare_set set = { NULL, 0, 0 };
+    compare_bucket b;
+    double threshold = 0.05, alpha = 0.01;
+    unsigned runs[2] = { 0, 0 }, i, j, slower = 0, buckets = 0, dropped = 0, side = 0;
+    int opt, split = 0;
+
+    argv0 = argv[0];
+
+    // '+': stop at the first file, so the -- between the sides is kept
+    while((opt = getopt(argc, argv, "+t:a:o:h")) != -1) {
+        switch(opt) {
+            case 't':
+                threshold = atof(optarg) / 100;
+                break;
+            case 'a':
+                alpha = atof(optarg);
+                break;
+            case 'o':
+                wide_op = optarg;
+                break;
+            default:
+                usage();
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    for(i = optind; i < (unsigned)argc; i++)
+        split += !strcmp(argv[i], "--");
+
+    if(split > 1 || (!split && argc - optind != 2)) {
+        usage();
+        return 2;
+    }
+
+    for(i = optind; i < (unsigned)argc; i++) {
+        if(!strcmp(argv[i], "--")) {
+            side = 1;
+            continue;
+        }
+
+        if(runs[side] == COMPARE_RUNS_MAX) {
+            fprintf(stderr, "%s: more than %u runs on a side\n", argv0, COMPARE_RUNS_MAX);
+            return 2;
+        }
+
+        read_results(argv[i], &set, side, runs[side]++);
+
+        // Without --, the second file is the candidate
+        if(!split)
+            side = 1;
+    }
+
+    if(!runs[0] || !runs[1]) {
+        usage();
+        return 2;
+    }
+
+    qsort(set.rows, set.count, sizeof(compare_row), compare_rows);
+
+    printf("Operation,Implementation,Src_Align,Dst_Align,Cache,Variant,Bucket_Min,Bucket_Max,Sizes,Ratio,P_Value,Test,Verdict\n");
+
+    memset(&b, 0, sizeof(b));
+
+    // Rows arrive grouped by key, then by size
+    for(i = 0; i < set.count; i = j) {
+        const compare_row *x = &set.rows[i];
+
+        for(j = i + 1; j < set.count && !compare_key(x, &set.rows[j]) && set.rows[j].bytes == x->bytes; j++)
+            ;
+
+        if(!b.key || compare_key(b.key, x) || b.bucket != bucket_of(x->bytes)) {
+            if(b.key) {
+                slower += finish_bucket(&b, runs, threshold, alpha);
+                buckets += b.sizes > 0;
+            }
+
+            memset(&b, 0, sizeof(b));
+            b.key = x;
+            b.bucket = bucket_of(x->bytes);
+        }
+
+        dropped += !add_size(&b, x, j - i, runs);
+    }
+
+    if(b.key) {
+        slower += finish_bucket(&b, runs, threshold, alpha);
+        buckets += b.sizes > 0;
+    }
+
+    fprintf(stderr, "compare: %u+%u runs, %u buckets, %u slower, %u sizes not in every run\n", runs[0], runs[1],
+        buckets, slower, dropped);
+    if(runs[0] < 2 || runs[1] < 2)
+        fprintf(stderr, "compare: nothing tested, give two or more runs per side to find slowdowns\n");
+
+    free(set.rows);
+    return slower ? 1 : 0;
+}
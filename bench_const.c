@@ -0,0 +1,98 @@
+// Constant-size call sites vs the runtime path
+//
+// Each size gets its own wrappers with the length as a literal, so
+// memfuncs_inline.h can expand it at compile time. The wrappers are called
+// through the same function pointer as libc and moop, so every row pays the
+// same call overhead and the difference is the body alone.
+//
+// *_Inline promises the alignment with the *_aligned macros; *_Inline_Typed
+// is a plain call on pointers to an 8-byte aligned struct, the usual struct
+// copy, where the alignment has to come from the type. `make check-inline`
+// checks that the typed wrappers don't call the runtime functions.
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "memfuncs_inline.h"
+
+#define CONST_SIZES(X) X(4) X(8) X(12) X(16) X(24) X(32) X(48) X(64) X(128)
+#define CONST_MAX_SIZE 128
+
+#define CONST_WRAPPERS(n) \
+    struct const_block_##n { uint8_t b[n]; } __attribute__((aligned(8))); \
+    static void * memcpy_inline_##n(void *dest, const void *src, size_t len) { \
+        (void)len; \
+        return memcpy_inline_aligned(dest, src, n, 8); \
+    } \
+    static void * memset_inline_##n(void *dest, int c, size_t len) { \
+        (void)len; \
+        return memset_inline_aligned(dest, c, n, 8); \
+    } \
+    static void * memcpy_typed_##n(void *dest, const void *src, size_t len) { \
+        struct const_block_##n *d = dest; \
+        const struct const_block_##n *s = src; \
+        (void)len; \
+        return memcpy_inline(d, s, n); \
+    } \
+    static void * memset_typed_##n(void *dest, int c, size_t len) { \
+        struct const_block_##n *d = dest; \
+        (void)len; \
+        return memset_inline(d, c, n); \
+    }
+
+CONST_SIZES(CONST_WRAPPERS)
+
+#define CONST_ENTRY(n) { n, memcpy_inline_##n, memset_inline_##n, memcpy_typed_##n, memset_typed_##n },
+
+static const struct {
+    size_t len;
+    bench_copy_fn copy;
+    bench_set_fn set;
+    bench_copy_fn typed_copy;
+    bench_set_fn typed_set;
+} const_cases[] = {
+    CONST_SIZES(CONST_ENTRY)
+};
+
+static const bench_op const_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMSET };
+
+static uint8_t src_buf[CONST_MAX_SIZE]__attribute__((aligned(32)));
+static uint8_t dst_buf[CONST_MAX_SIZE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+void bench_const_sweep(const bench_config *cfg) {
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align = { 0, 0 };
+    unsigned o, i;
+
+    bench_result_header(cfg->format, NULL);
+
+    args.src = src_buf;
+    args.dst = dst_buf + BENCH_GUARD;
+    args.val = 0x5a;
+
+    for(o = 0; o < sizeof(const_ops) / sizeof(const_ops[0]); o++) {
+        bench_op op = const_ops[o];
+
+        for(i = 0; i < sizeof(const_cases) / sizeof(const_cases[0]); i++) {
+            bench_impl inline_impl = { op == BENCH_OP_MEMSET ? "Memset_Inline" : "Memcpy_Inline",
+                op, const_cases[i].copy, const_cases[i].set, -1 };
+            bench_impl typed_impl = { op == BENCH_OP_MEMSET ? "Memset_Inline_Typed" : "Memcpy_Inline_Typed",
+                op, const_cases[i].typed_copy, const_cases[i].typed_set, -1 };
+
+            args.len = const_cases[i].len;
+
+            for(impl = bench_impls(op); impl->name; impl++) {
+                bench_run(cfg, impl, &args, &stats);
+                bench_result_print(cfg->format, cfg, op, impl->name, args.len, &align, &stats, NULL);
+            }
+
+            bench_run(cfg, &inline_impl, &args, &stats);
+            bench_result_print(cfg->format, cfg, op, inline_impl.name, args.len, &align, &stats, NULL);
+
+            bench_run(cfg, &typed_impl, &args, &stats);
+            bench_result_print(cfg->format, cfg, op, typed_impl.name, args.len, &align, &stats, NULL);
+        }
+    }
+}
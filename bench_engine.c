@@ -0,0 +1,459 @@
+// Benchmark measurement engine
+//
+// See bench.h for the overall flow.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bench.h"
+#include "platform.h"
+
+// Timer reads used to measure the empty-region overhead
+#define TIMER_CALIBRATION_READS 101
+
+static double *sample_buf;
+static size_t sample_cap;
+
+static uint8_t *ref_buf;
+static size_t ref_cap;
+
+static uint32_t rng_state = 0x2545f491;
+
+// xorshift32, much cheaper than rand() for refilling buffers every repetition
+static void fill_random(uint8_t *p, size_t len) {
+    uint32_t x = rng_state;
+
+    while(len--) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        *p++ = (uint8_t)x;
+    }
+
+    rng_state = x;
+}
+
+static void * grow(void *buf, size_t *cap, size_t need, size_t elem) {
+    if(need <= *cap)
+        return buf;
+
+    buf = realloc(buf, need * elem);
+    if(!buf) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    *cap = need;
+    return buf;
+}
+
+static inline void invoke(const bench_impl *impl, const bench_args *args) {
+    if(impl->op == BENCH_OP_MEMSET)
+        impl->set(args->dst, args->val, args->len);
+    else
+        impl->copy(args->dst, args->src, args->len);
+}
+
+// Leave the buffers in the requested cache state. The refill in prepare()
+// has just written all of them, which is the warm state.
+static void set_cache_state(bench_cache cache, const bench_impl *impl, const bench_args *args) {
+    size_t window = args->len + 2 * BENCH_GUARD;
+    volatile const uint8_t *s = args->src;
+    size_t i;
+
+    if(cache == BENCH_CACHE_WARM)
+        return;
+
+    platform_cache_purge(args->dst - BENCH_GUARD, window);
+
+    if(impl->op == BENCH_OP_MEMSET)
+        return;
+
+    if(cache == BENCH_CACHE_COLD) {
+        platform_cache_purge(args->src, args->len);
+        return;
+    }
+
+    // The purge may have evicted more than the destination (it does on
+    // hosted x86), so pull the source back in
+    for(i = 0; i < args->len; i += 32) // one read per SH4 cache line
+        (void)s[i];
+}
+
+// Fresh data in the destination window and the source, then the expected
+// result of the call (computed with libc) in ref_buf. The source is read
+// before the call, so this is also right for overlapping memmove.
+static void prepare(const bench_config *cfg, const bench_impl *impl, const bench_args *args) {
+    size_t window = args->len + 2 * BENCH_GUARD;
+
+    ref_buf = grow(ref_buf, &ref_cap, window, 1);
+
+    fill_random(args->dst - BENCH_GUARD, window);
+    if(impl->op != BENCH_OP_MEMSET)
+        fill_random((uint8_t *)args->src, args->len);
+
+    memcpy(ref_buf, args->dst - BENCH_GUARD, window);
+
+    if(impl->op == BENCH_OP_MEMSET)
+        memset(ref_buf + BENCH_GUARD, args->val, args->len);
+    else if(impl->op != BENCH_OP_READ)
+        memmove(ref_buf + BENCH_GUARD, args->src, args->len);
+
+    set_cache_state(cfg->cache, impl, args);
+}
+
+static void verify(const bench_impl *impl, const bench_args *args) {
+    if(memcmp(args->dst - BENCH_GUARD, ref_buf, args->len + 2 * BENCH_GUARD)) {
+        fprintf(stderr, "bench: %s produced a wrong result (len %u, dst %p, src %p)\n",
+            impl->name, (unsigned)args->len, (void *)args->dst, (const void *)args->src);
+        abort();
+    }
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double median_of_sorted(const double *v, unsigned count) {
+    if(count & 1)
+        return v[count / 2];
+
+    return (v[count / 2 - 1] + v[count / 2]) / 2;
+}
+
+// Median cost of an empty timed region, i.e. two back-to-back timer reads.
+// Subtracted from every sample.
+static double timer_overhead;
+
+// Smallest step the timer advances by (about 80 ns for timer_ns_gettime64
+// on KOS).
+static double timer_quantum = 1;
+
+void bench_timer_init(void) {
+    double reads[TIMER_CALIBRATION_READS];
+    unsigned i;
+
+    for(i = 0; i < TIMER_CALIBRATION_READS; i++) {
+        uint64_t start = platform_time_ns();
+        reads[i] = (double)(platform_time_ns() - start);
+    }
+
+    qsort(reads, TIMER_CALIBRATION_READS, sizeof(double), compare_double);
+    timer_overhead = median_of_sorted(reads, TIMER_CALIBRATION_READS);
+
+    // Spin from an arbitrary read until the value changes; the jump is one
+    // quantum wherever in the tick the first read landed
+    for(i = 0; i < TIMER_CALIBRATION_READS; i++) {
+        uint64_t start = platform_time_ns();
+        uint64_t now;
+
+        while((now = platform_time_ns()) == start)
+            ;
+
+        if(!i || (double)(now - start) < timer_quantum)
+            timer_quantum = (double)(now - start);
+    }
+
+    fprintf(stderr, "bench: timer overhead %.1f ns (subtracted), resolution %.1f ns, %.0f MHz CPU\n",
+        timer_overhead, timer_quantum, platform_cpu_mhz());
+}
+
+double bench_time_batch(bench_batch_fn run, void *ctx, unsigned count) {
+    uint64_t start = platform_time_ns();
+    uint64_t end;
+
+    run(ctx, count);
+    end = platform_time_ns();
+
+    double elapsed = (double)(end - start) - timer_overhead;
+    return elapsed > 0 ? elapsed : 0;
+}
+
+typedef struct {
+    const bench_impl *impl;
+    const bench_args *args;
+} engine_call;
+
+static void run_impl(void *ctx, unsigned count) {
+    const engine_call *call = ctx;
+    unsigned i;
+
+    for(i = 0; i < count; i++)
+        invoke(call->impl, call->args);
+}
+
+// Time count back-to-back calls, less the timer overhead
+static double time_batch(const bench_impl *impl, const bench_args *args, unsigned count) {
+    engine_call call = { impl, args };
+
+    return bench_time_batch(run_impl, &call, count);
+}
+
+// Calls per sample: cfg->batch, or for 0 the smallest power of two that
+// makes a sample last BENCH_BATCH_TARGET_NS. Purged buffers only stay cold
+// for the first call, so the cold states never batch.
+static unsigned batch_size(const bench_config *cfg, const bench_impl *impl, const bench_args *args) {
+    unsigned count = 1;
+
+    if(cfg->cache != BENCH_CACHE_WARM)
+        return 1;
+    if(cfg->batch)
+        return cfg->batch;
+
+    while(count < BENCH_BATCH_MAX) {
+        prepare(cfg, impl, args);
+        if(time_batch(impl, args, count) >= BENCH_BATCH_TARGET_NS)
+            break;
+        count *= 2;
+    }
+
+    return count;
+}
+
+void bench_measure(const bench_config *cfg, bench_batch_fn run, void *ctx, double *samples, bench_stats *stats) {
+    unsigned count = 1;
+    unsigned i;
+
+    run(ctx, cfg->warmup);
+
+    // Same sizing as batch_size(), without the refill
+    if(cfg->batch)
+        count = cfg->batch;
+    else
+        while(count < BENCH_BATCH_MAX && bench_time_batch(run, ctx, count) < BENCH_BATCH_TARGET_NS)
+            count *= 2;
+
+    for(i = 0; i < cfg->repetitions; i++)
+        samples[i] = bench_time_batch(run, ctx, count) / count;
+
+    bench_stats_compute(samples, cfg->repetitions, count, cfg->outlier_z, stats);
+    stats->cycles = stats->median * platform_cpu_mhz() / 1000.0;
+}
+
+size_t bench_next_size(size_t len) {
+    size_t pow = 1;
+
+    if(len >= 2 && !(len & (len - 1)))
+        return len + len / 2;
+
+    while(pow <= len)
+        pow *= 2;
+
+    return pow;
+}
+
+// Repeating a memmove whose ranges overlap moves the data again each time
+static int repeat_safe(const bench_impl *impl, const bench_args *args) {
+    if(impl->op != BENCH_OP_MEMMOVE)
+        return 1;
+
+    return args->src + args->len <= args->dst || args->dst + args->len <= args->src;
+}
+
+// Event counts of one batch per counter pass, for every run
+static void count_runs(const bench_config *cfg, const bench_impl *impl, const bench_args *args,
+        unsigned batch, uint64_t runs[BENCH_COUNTER_RUNS][COUNTER_EVENTS]) {
+    const counter_backend *counters = cfg->counters;
+    unsigned pass, r, i;
+
+    memset(runs, 0, BENCH_COUNTER_RUNS * sizeof(runs[0]));
+
+    for(pass = 0; pass < counters->passes; pass++) {
+        for(r = 0; r < BENCH_COUNTER_RUNS; r++) {
+            if(batch)
+                prepare(cfg, impl, args);
+
+            counters->start(pass);
+            for(i = 0; i < batch; i++)
+                invoke(impl, args);
+            counters->stop(pass, runs[r]);
+        }
+    }
+}
+
+static double median_event(uint64_t runs[BENCH_COUNTER_RUNS][COUNTER_EVENTS], unsigned event) {
+    double v[BENCH_COUNTER_RUNS];
+    unsigned r;
+
+    for(r = 0; r < BENCH_COUNTER_RUNS; r++)
+        v[r] = (double)runs[r][event];
+
+    qsort(v, BENCH_COUNTER_RUNS, sizeof(double), compare_double);
+    return median_of_sorted(v, BENCH_COUNTER_RUNS);
+}
+
+// Median events per byte over BENCH_COUNTER_RUNS batches, less the events of
+// an empty start/stop (measured once per backend, like the timer overhead)
+static void count_events(const bench_config *cfg, const bench_impl *impl, const bench_args *args,
+        unsigned batch, bench_stats *stats) {
+    static const counter_backend *calibrated;
+    static double overhead[COUNTER_EVENTS];
+    uint64_t runs[BENCH_COUNTER_RUNS][COUNTER_EVENTS];
+    double bytes = (double)batch * (double)(args->len ? args->len : 1);
+    unsigned e;
+
+    if(calibrated != cfg->counters) {
+        count_runs(cfg, impl, args, 0, runs);
+        for(e = 0; e < COUNTER_EVENTS; e++)
+            overhead[e] = median_event(runs, e);
+        calibrated = cfg->counters;
+    }
+
+    count_runs(cfg, impl, args, batch, runs);
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        double count = median_event(runs, e) - overhead[e];
+
+        stats->per_byte[e] = count > 0 ? count / bytes : 0;
+    }
+
+    stats->counted = cfg->counter_events;
+}
+
+void bench_run(const bench_config *cfg, const bench_impl *impl, const bench_args *args, bench_stats *stats) {
+    unsigned i, batch;
+
+    sample_buf = grow(sample_buf, &sample_cap, cfg->repetitions, sizeof(double));
+
+    for(i = 0; i < cfg->warmup; i++) {
+        prepare(cfg, impl, args);
+        invoke(impl, args);
+    }
+
+    batch = batch_size(cfg, impl, args);
+
+    for(i = 0; i < cfg->repetitions; i++) {
+        prepare(cfg, impl, args);
+
+        sample_buf[i] = time_batch(impl, args, batch) / batch;
+
+        if(batch > 1 && !repeat_safe(impl, args)) {
+            prepare(cfg, impl, args);
+            invoke(impl, args);
+        }
+
+        verify(impl, args);
+    }
+
+    bench_stats_compute(sample_buf, cfg->repetitions, batch, cfg->outlier_z, stats);
+    stats->cycles = stats->median * platform_cpu_mhz() / 1000.0;
+
+    if(cfg->counters)
+        count_events(cfg, impl, args, batch, stats);
+}
+
+void bench_stats_compute(double *samples, unsigned count, unsigned batch, double outlier_z, bench_stats *stats) {
+    unsigned i;
+    unsigned kept = count;
+
+    memset(stats, 0, sizeof(*stats));
+    if(!count)
+        return;
+
+    qsort(samples, count, sizeof(double), compare_double);
+
+    // Modified z-score (Iglewicz & Hoaglin): 0.6745 * (x - median) / MAD.
+    // Timing noise only ever adds time, so only the slow side is trimmed.
+    if(outlier_z > 0 && count >= 3) {
+        double median = median_of_sorted(samples, count);
+        double *dev = malloc(count * sizeof(double));
+
+        if(dev) {
+            for(i = 0; i < count; i++)
+                dev[i] = fabs(samples[i] - median);
+
+            qsort(dev, count, sizeof(double), compare_double);
+
+            // All samples (nearly) identical: keep one timer quantum, which
+            // dividing by the batch has shrunk along with the samples
+            double mad = median_of_sorted(dev, count);
+            double quantum = timer_quantum / batch;
+            if(mad < quantum)
+                mad = quantum;
+
+            while(kept > 1 && 0.6745 * (samples[kept - 1] - median) / mad > outlier_z)
+                kept--;
+
+            free(dev);
+        }
+    }
+
+    double sum = 0;
+    for(i = 0; i < kept; i++)
+        sum += samples[i];
+
+    double mean = sum / kept;
+    double var = 0;
+    for(i = 0; i < kept; i++)
+        var += (samples[i] - mean) * (samples[i] - mean);
+
+    unsigned p99_rank = (unsigned)ceil(0.99 * kept); // nearest-rank
+
+    stats->min = samples[0];
+    stats->max = samples[kept - 1];
+    stats->median = median_of_sorted(samples, kept);
+    stats->p99 = samples[(p99_rank ? p99_rank : 1) - 1];
+    stats->mean = mean;
+    stats->stddev = kept > 1 ? sqrt(var / (kept - 1)) : 0;
+    stats->samples = kept;
+    stats->rejected = count - kept;
+    stats->batch = batch;
+}
+
+void bench_print_stats_header(const char *name) {
+    unsigned e;
+
+    if(!name) {
+        printf(",Min,Median,Mean,P99,Stddev,Cycles,Batch");
+        for(e = 0; e < COUNTER_EVENTS; e++)
+            printf(",%s_Per_Byte", counter_event_name(e));
+        return;
+    }
+
+    printf(",%s_Min,%s_Median,%s_Mean,%s_P99,%s_Stddev,%s_Cycles,%s_Batch", name, name, name, name, name, name, name);
+    for(e = 0; e < COUNTER_EVENTS; e++)
+        printf(",%s_%s_Per_Byte", name, counter_event_name(e));
+}
+
+// Counter columns are left empty when the event wasn't counted
+void bench_print_stats(const bench_stats *stats) {
+    unsigned e;
+
+    printf(",%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%u", stats->min, stats->median,
+        stats->mean, stats->p99, stats->stddev, stats->cycles, stats->batch);
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        if(stats->counted & (1u << e))
+            printf(",%.4f", stats->per_byte[e]);
+        else
+            printf(",");
+    }
+}
+
+uint8_t * bench_alloc(size_t len, void **raw) {
+    *raw = malloc(len + 31);
+    if(!*raw) {
+        fprintf(stderr, "bench: can't allocate %u bytes\n", (unsigned)len);
+        abort();
+    }
+
+    return (uint8_t *)(((uintptr_t)*raw + 31) & ~(uintptr_t)31);
+}
+
+const char * bench_cache_name(bench_cache cache) {
+    switch(cache) {
+        case BENCH_CACHE_WARM:
+            return "warm";
+        case BENCH_CACHE_COLD:
+            return "cold";
+        case BENCH_CACHE_DST_COLD:
+            return "dst-cold";
+    }
+
+    return "?";
+}
@@ -0,0 +1,85 @@
+// Implementation tables for the benchmark
+
+#include <string.h>
+
+#include "bench.h"
+#include "memauto.h"
+#include "memfuncs.h"
+#ifdef MEMAUTO_HAVE_FASTMEM
+#include "fastmem.h"
+#endif
+
+// memset_moop takes the fill pattern as a full 32-bit word
+static void * memset_moop_byte(void *dest, int c, size_t n) {
+    return memset_moop(dest, (uint8_t)c * 0x01010101u, n);
+}
+
+static const bench_impl memcpy_impls[] = {
+    { "Memcpy", BENCH_OP_MEMCPY, memcpy, NULL, MEMAUTO_LIBC },
+    { "Memcpy_Moop", BENCH_OP_MEMCPY, memcpy_moop, NULL, MEMAUTO_MOOP },
+#ifdef MEMAUTO_HAVE_FASTMEM
+    { "Memcpy_Fast", BENCH_OP_MEMCPY, memcpy_fast, NULL, MEMAUTO_FAST },
+#endif
+    { "Memcpy_Auto", BENCH_OP_MEMCPY, memcpy_auto, NULL, -1 },
+    { NULL },
+};
+
+static const bench_impl memmove_impls[] = {
+    { "Memmove", BENCH_OP_MEMMOVE, memmove, NULL, MEMAUTO_LIBC },
+    { "Memmove_Moop", BENCH_OP_MEMMOVE, memmove_moop, NULL, MEMAUTO_MOOP },
+#ifdef MEMAUTO_HAVE_FASTMEM
+    { "Memmove_Fast", BENCH_OP_MEMMOVE, memmove_fast, NULL, MEMAUTO_FAST },
+#endif
+    { "Memmove_Auto", BENCH_OP_MEMMOVE, memmove_auto, NULL, -1 },
+    { NULL },
+};
+
+static const bench_impl memset_impls[] = {
+    { "Memset", BENCH_OP_MEMSET, NULL, memset, MEMAUTO_LIBC },
+    { "Memset_Moop", BENCH_OP_MEMSET, NULL, memset_moop_byte, MEMAUTO_MOOP },
+#ifdef MEMAUTO_HAVE_FASTMEM
+    { "Memset_Fast", BENCH_OP_MEMSET, NULL, memset_fast, MEMAUTO_FAST },
+#endif
+    { "Memset_Auto", BENCH_OP_MEMSET, NULL, memset_auto, -1 },
+    { NULL },
+};
+
+const bench_impl * bench_impls(bench_op op) {
+    switch(op) {
+        case BENCH_OP_MEMCPY:
+            return memcpy_impls;
+        case BENCH_OP_MEMMOVE:
+            return memmove_impls;
+        case BENCH_OP_MEMSET:
+            return memset_impls;
+        default:
+            break; // only the roofline loops read, the rest have their own modes
+    }
+
+    return NULL;
+}
+
+const char * bench_op_name(bench_op op) {
+    switch(op) {
+        case BENCH_OP_MEMCPY:
+            return "memcpy";
+        case BENCH_OP_MEMMOVE:
+            return "memmove";
+        case BENCH_OP_MEMSET:
+            return "memset";
+        case BENCH_OP_READ:
+            return "read";
+        case BENCH_OP_MEMCMP:
+            return "memcmp";
+        case BENCH_OP_STRLEN:
+            return "strlen";
+        case BENCH_OP_MEMCHR:
+            return "memchr";
+        case BENCH_OP_STRCHR:
+            return "strchr";
+        case BENCH_OP_REPLAY:
+            return "replay";
+    }
+
+    return "?";
+}
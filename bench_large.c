@@ -0,0 +1,121 @@
+// Large working-set sweep
+//
+// The other suites stay well inside the 16 KB operand cache. This one runs
+// every operation and implementation from 32 bytes up to max_size (several MB
+// if the machine has the memory) on heap buffers, and reports throughput so
+// in-cache and out-of-cache bandwidth can be read straight off the CSV.
+//
+// Sizes are log-spaced, LARGE_STEPS_PER_OCTAVE per doubling, plus a dense
+// run of LARGE_DENSE_STEPS sizes from 3/4 to 5/4 of each size in
+// LARGE_CACHE_BOUNDARIES, where the curve bends. Every size is a multiple of
+// 32 bytes (one cache line).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bench.h"
+
+#define LARGE_MIN_SIZE 32
+#define LARGE_STEPS_PER_OCTAVE 4
+#define LARGE_DENSE_STEPS 9
+
+// SH4 operand cache with and without the OC RAM split. Override with
+// -DLARGE_CACHE_BOUNDARIES=... to sample around a host's cache sizes.
+#ifndef LARGE_CACHE_BOUNDARIES
+#define LARGE_CACHE_BOUNDARIES 8192, 16384
+#endif
+
+static const size_t large_boundaries[] = { LARGE_CACHE_BOUNDARIES };
+
+static const bench_op large_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+static int compare_size(const void *a, const void *b) {
+    size_t x = *(const size_t *)a;
+    size_t y = *(const size_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Sorted, deduplicated size schedule up to max_size. Returns the count.
+static unsigned large_schedule(size_t max_size, size_t **sizes) {
+    unsigned cap = 64 * LARGE_STEPS_PER_OCTAVE + LARGE_DENSE_STEPS * (sizeof(large_boundaries) / sizeof(large_boundaries[0]));
+    unsigned count = 0, i, k;
+    size_t octave, size;
+
+    *sizes = malloc(cap * sizeof(size_t));
+    if(!*sizes) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    for(octave = LARGE_MIN_SIZE; octave <= max_size && octave <= ((size_t)-1 >> 1); octave *= 2) {
+        for(k = 0; k < LARGE_STEPS_PER_OCTAVE; k++) {
+            size = (size_t)((double)octave * pow(2.0, (double)k / LARGE_STEPS_PER_OCTAVE));
+            size = (size + 31) & ~(size_t)31;
+            if(size <= max_size)
+                (*sizes)[count++] = size;
+        }
+    }
+
+    for(i = 0; i < sizeof(large_boundaries) / sizeof(large_boundaries[0]); i++) {
+        size_t lo = large_boundaries[i] * 3 / 4;
+        size_t step = large_boundaries[i] / 2 / (LARGE_DENSE_STEPS - 1);
+
+        for(k = 0; k < LARGE_DENSE_STEPS; k++) {
+            size = (lo + k * step + 31) & ~(size_t)31;
+            if(size <= max_size)
+                (*sizes)[count++] = size;
+        }
+    }
+
+    qsort(*sizes, count, sizeof(size_t), compare_size);
+
+    for(i = k = 0; i < count; i++) {
+        if(!k || (*sizes)[i] != (*sizes)[k - 1])
+            (*sizes)[k++] = (*sizes)[i];
+    }
+
+    return k;
+}
+
+void bench_large_sweep(const bench_config *cfg, size_t max_size) {
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align = { 0, 0 };
+    bench_extra extra = { 0, 1, { "MB_s" } }; // from the median, 10^6 bytes per second
+    void *src_raw, *dst_raw;
+    size_t *sizes;
+    unsigned count, o, i;
+
+    if(max_size < LARGE_MIN_SIZE)
+        max_size = LARGE_MIN_SIZE;
+
+    count = large_schedule(max_size, &sizes);
+
+    args.src = bench_alloc(max_size, &src_raw);
+    args.dst = bench_alloc(max_size + 2 * BENCH_GUARD, &dst_raw) + BENCH_GUARD;
+    args.val = 0x5a;
+
+    bench_result_header(cfg->format, &extra);
+
+    for(o = 0; o < sizeof(large_ops) / sizeof(large_ops[0]); o++) {
+        bench_op op = large_ops[o];
+
+        for(i = 0; i < count; i++) {
+            args.len = sizes[i];
+
+            for(impl = bench_impls(op); impl->name; impl++) {
+                bench_run(cfg, impl, &args, &stats);
+
+                bench_extra_set(&extra, 0, "%.1f", stats.median > 0 ? (double)args.len * 1000.0 / stats.median : 0.0);
+                bench_result_print(cfg->format, cfg, op, impl->name, args.len, &align, &stats, &extra);
+            }
+        }
+    }
+
+    free(sizes);
+    free(src_raw);
+    free(dst_raw);
+}
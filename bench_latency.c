@@ -0,0 +1,202 @@
+// Load latency and prefetch distance tuning
+//
+// Pointer chase over working sets from LATENCY_MIN_SIZE up to max_size: every
+// 32-byte line holds a pointer to the next one in a random single cycle
+// (Sattolo's shuffle), so each load depends on the last and the hardware can
+// neither overlap nor predict them. The time per load is the latency of
+// whichever level the working set fits in.
+//
+// The smallest size gives the L1 plateau and the largest the RAM plateau, so
+// max_size has to be well past the last cache level. A prefetch has to be
+// issued at least (RAM - L1) before its line is used; dividing that by the
+// time memcpy_64bit_32Bytes_movca takes per cached line gives the prefetch
+// distance in lines. The result is printed as memfuncs_tuning.h on stdout,
+// with the measured curve in its comment.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+#include "platform.h"
+
+#define LATENCY_MIN_SIZE 1024
+#define LATENCY_LINE 32
+#define LATENCY_STEPS 65536 // dependent loads per sample
+#define LATENCY_MAX_PREF_LINES 8
+
+// Copy loop timed in cache for the per-line cost, 4 KB like the roofline
+#define LATENCY_COPY_SIZE 4096
+
+static uint32_t latency_rng = 0x2545f491;
+
+static uint32_t latency_random(void) {
+    uint32_t x = latency_rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return latency_rng = x;
+}
+
+// One random cycle through all lines of [buf, buf + size)
+static void latency_link(uint8_t *buf, size_t size, size_t *order) {
+    size_t lines = size / LATENCY_LINE;
+    size_t i;
+
+    for(i = 0; i < lines; i++)
+        order[i] = i;
+
+    // Sattolo: j < i, never j == i, so the permutation is one cycle
+    for(i = lines - 1; i > 0; i--) {
+        size_t j = latency_random() % i;
+        size_t t = order[i];
+
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    for(i = 0; i < lines; i++)
+        *(void **)(buf + order[i] * LATENCY_LINE) = buf + order[(i + 1) % lines] * LATENCY_LINE;
+}
+
+static void * latency_chase(void *p, unsigned steps) {
+    steps /= 8;
+
+    do {
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+        p = *(void **)p;
+    } while(--steps);
+
+    return p;
+}
+
+// Median ns per dependent load over a working set of size bytes
+static double latency_measure(const bench_config *cfg, uint8_t *buf, size_t size, size_t *order) {
+    double *samples = malloc(cfg->repetitions * sizeof(double));
+    bench_stats stats;
+    void * volatile sink;
+    void *p = buf;
+    unsigned i;
+
+    if(!samples) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    latency_link(buf, size, order);
+
+    for(i = 0; i < cfg->warmup; i++)
+        p = latency_chase(p, LATENCY_STEPS);
+
+    for(i = 0; i < cfg->repetitions; i++) {
+        uint64_t start = platform_time_ns();
+
+        p = latency_chase(p, LATENCY_STEPS);
+        samples[i] = (double)(platform_time_ns() - start) / LATENCY_STEPS;
+    }
+
+    sink = p;
+    (void)sink;
+
+    bench_stats_compute(samples, cfg->repetitions, LATENCY_STEPS, cfg->outlier_z, &stats);
+    free(samples);
+    return stats.median;
+}
+
+static void * latency_copy_lines(void *dest, const void *src, size_t n) {
+    return memcpy_64bit_32Bytes_movca(dest, src, n / LATENCY_LINE);
+}
+
+// Median ns the line copy loop spends on each cached line
+static double latency_line_cost(const bench_config *cfg, uint8_t *src, uint8_t *dst) {
+    bench_impl impl = { "Memcpy_64bit_32Bytes_movca", BENCH_OP_MEMCPY, latency_copy_lines, NULL, -1 };
+    bench_config warm = *cfg;
+    bench_args args;
+    bench_stats stats;
+
+    warm.cache = BENCH_CACHE_WARM;
+    args.src = src;
+    args.dst = dst;
+    args.len = LATENCY_COPY_SIZE;
+    args.val = 0;
+
+    bench_run(&warm, &impl, &args, &stats);
+    return stats.median / (LATENCY_COPY_SIZE / LATENCY_LINE);
+}
+
+void bench_latency(const bench_config *cfg, size_t max_size) {
+    double mhz = platform_cpu_mhz();
+    double l1, ram, line_ns;
+    unsigned count = 0, i, pref_lines;
+    size_t sizes[64], size, *order;
+    double ns[64];
+    uint8_t *buf, *dst;
+    void *buf_raw, *dst_raw;
+
+    if(max_size < LATENCY_MIN_SIZE)
+        max_size = LATENCY_MIN_SIZE;
+
+    // Doublings and the midpoints between them
+    for(size = LATENCY_MIN_SIZE; size <= max_size && count < 62; size *= 2) {
+        sizes[count++] = size;
+        if(size + size / 2 <= max_size)
+            sizes[count++] = size + size / 2;
+    }
+
+    buf = bench_alloc(max_size, &buf_raw);
+    dst = bench_alloc(LATENCY_COPY_SIZE + 2 * BENCH_GUARD, &dst_raw) + BENCH_GUARD;
+    order = malloc(max_size / LATENCY_LINE * sizeof(size_t));
+    if(!order) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    for(i = 0; i < count; i++) {
+        ns[i] = latency_measure(cfg, buf, sizes[i], order);
+        fprintf(stderr, "latency: %u bytes %.1f ns\n", (unsigned)sizes[i], ns[i]);
+    }
+
+    line_ns = latency_line_cost(cfg, buf, dst);
+
+    l1 = ns[0];
+    ram = ns[count - 1];
+    pref_lines = line_ns > 0 ? (unsigned)ceil((ram - l1) / line_ns) : LATENCY_MAX_PREF_LINES;
+    if(pref_lines < 1)
+        pref_lines = 1;
+    if(pref_lines > LATENCY_MAX_PREF_LINES)
+        pref_lines = LATENCY_MAX_PREF_LINES;
+
+    printf("// Generated by \"membench latency\" on %s. Rerun it on the target\n", platform_name());
+    printf("// machine instead of editing this file by hand.\n");
+    printf("//\n");
+    printf("// Pointer-chase latency, one dependent load per random %d-byte line:\n", LATENCY_LINE);
+    printf("//\n");
+    printf("//   %10s %10s %10s\n", "Bytes", "Ns", "Cycles");
+    for(i = 0; i < count; i++)
+        printf("//   %10u %10.1f %10.1f\n", (unsigned)sizes[i], ns[i], ns[i] * mhz / 1000.0);
+    printf("//\n");
+    printf("// memcpy_64bit_32Bytes_movca copies a cached line in %.1f ns, so a\n", line_ns);
+    printf("// prefetch needs to be (%.1f - %.1f) / %.1f lines ahead, at most %d.\n", ram, l1, line_ns, LATENCY_MAX_PREF_LINES);
+    printf("\n");
+    printf("#ifndef __MEMFUNCS_TUNING_H_\n");
+    printf("#define __MEMFUNCS_TUNING_H_\n");
+    printf("\n");
+    printf("#define MEMFUNCS_L1_LATENCY_CYCLES %u\n", (unsigned)(l1 * mhz / 1000.0 + 0.5));
+    printf("#define MEMFUNCS_RAM_LATENCY_CYCLES %u\n", (unsigned)(ram * mhz / 1000.0 + 0.5));
+    printf("\n");
+    printf("#define MEMFUNCS_PREF_LINES %u\n", pref_lines);
+    printf("\n");
+    printf("#endif /* __MEMFUNCS_TUNING_H_ */\n");
+
+    free(order);
+    free(buf_raw);
+    free(dst_raw);
+}
@@ -0,0 +1,143 @@
+// memcmp by mismatch position
+//
+// A compare costs as much as the equal prefix in front of the first
+// difference, so every size is timed with the buffers equal and with one
+// byte differing at the start, the middle and the end. Each of those runs at
+// three alignments: both on a boundary, co-misaligned (memcmp_moop peels head
+// bytes) and misaligned to each other (it merges shifted words).
+//
+// The differing byte has its top bit flipped, which also checks that bytes
+// are compared as unsigned char. Every implementation's result is checked
+// against libc for its sign before it is timed. The buffers stay warm; the
+// -c cache state is ignored. MB_s is over the bytes up to and including the
+// differing one, i.e. what a compare has to look at. Rows are keyed by the
+// Mismatch position.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+
+typedef int (*memcmp_fn)(const void *str1, const void *str2, size_t n);
+
+static const struct {
+    const char *name;
+    memcmp_fn fn;
+} memcmp_impls[] = {
+    { "Memcmp", memcmp }, // first, the reference
+    { "Memcmp_Moop", memcmp_moop },
+};
+
+#define MEMCMP_IMPLS (sizeof(memcmp_impls) / sizeof(memcmp_impls[0]))
+
+static const bench_align memcmp_aligns[] = { { 0, 0 }, { 3, 3 }, { 1, 2 } };
+
+typedef enum {
+    MEMCMP_EQUAL,
+    MEMCMP_FIRST,
+    MEMCMP_MIDDLE,
+    MEMCMP_LAST,
+    MEMCMP_POSITIONS
+} memcmp_position;
+
+static const char * const memcmp_position_names[MEMCMP_POSITIONS] = { "none", "first", "middle", "last" };
+
+// Keeps the results alive so the calls can't be dropped
+static volatile int memcmp_sink;
+
+static int memcmp_sign(int r) {
+    return (r > 0) - (r < 0);
+}
+
+typedef struct {
+    memcmp_fn fn;
+    const uint8_t *a, *b;
+    size_t len;
+} memcmp_call;
+
+static void memcmp_run(void *ctx, unsigned count) {
+    const memcmp_call *call = ctx;
+    int sum = 0;
+    unsigned i;
+
+    for(i = 0; i < count; i++)
+        sum += call->fn(call->a, call->b, call->len);
+
+    memcmp_sink = sum;
+}
+
+static void memcmp_fill(uint8_t *p, size_t len) {
+    size_t i;
+
+    for(i = 0; i < len; i++)
+        p[i] = (uint8_t)(i * 97 + 13);
+}
+
+void bench_memcmp(const bench_config *cfg, size_t max_size) {
+    double *samples = malloc(cfg->repetitions * sizeof(double));
+    void *a_raw, *b_raw;
+    uint8_t *a_buf = bench_alloc(max_size + BENCH_MAX_ALIGN, &a_raw);
+    uint8_t *b_buf = bench_alloc(max_size + BENCH_MAX_ALIGN, &b_raw);
+    bench_extra extra = { 1, 2, { "Mismatch", "MB_s" } };
+    size_t len;
+    unsigned n, p, i;
+
+    if(!samples) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    memcmp_fill(a_buf, max_size + BENCH_MAX_ALIGN);
+
+    bench_result_header(cfg->format, &extra);
+
+    for(n = 0; n < sizeof(memcmp_aligns) / sizeof(memcmp_aligns[0]); n++) {
+        const bench_align *align = &memcmp_aligns[n];
+        const uint8_t *a = a_buf + align->src;
+        uint8_t *b = b_buf + align->dst;
+
+        for(len = 1; len <= max_size; len = bench_next_size(len)) {
+            for(p = 0; p < MEMCMP_POSITIONS; p++) {
+                size_t pos = p == MEMCMP_FIRST ? 0 : p == MEMCMP_MIDDLE ? len / 2 : len - 1;
+                size_t compared = p == MEMCMP_EQUAL ? len : pos + 1;
+                int expected = 0;
+
+                // One byte only has a first position
+                if(len == 1 && p > MEMCMP_FIRST)
+                    break;
+
+                memcpy(b, a, len);
+                if(p != MEMCMP_EQUAL)
+                    b[pos] ^= 0x80;
+
+                for(i = 0; i < MEMCMP_IMPLS; i++) {
+                    int sign = memcmp_sign(memcmp_impls[i].fn(a, b, len));
+                    memcmp_call call = { memcmp_impls[i].fn, a, b, len };
+                    bench_stats stats;
+
+                    if(!i)
+                        expected = sign;
+                    else if(sign != expected) {
+                        fprintf(stderr, "bench: %s at %u bytes, mismatch %s, returned sign %d, libc %d\n",
+                            memcmp_impls[i].name, (unsigned)len, memcmp_position_names[p], sign, expected);
+                        abort();
+                    }
+
+                    bench_measure(cfg, memcmp_run, &call, samples, &stats);
+
+                    bench_extra_set(&extra, 0, "%s", memcmp_position_names[p]);
+                    bench_extra_set(&extra, 1, "%.1f",
+                        stats.median > 0 ? (double)compared * 1000.0 / stats.median : 0.0);
+                    bench_result_print(cfg->format, cfg, BENCH_OP_MEMCMP, memcmp_impls[i].name, len, align, &stats,
+                        &extra);
+                }
+            }
+        }
+    }
+
+    free(samples);
+    free(a_raw);
+    free(b_raw);
+}
@@ -0,0 +1,239 @@
+// Command-line selection parsing
+//
+// See bench_selection in bench.h for what each field selects, and the usage
+// text in bench.c for the syntax.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "bench.h"
+
+// Schedules longer than this are almost certainly a typo
+#define OPTIONS_MAX_SIZES 1000000
+
+static const bench_op all_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+static int append_size(bench_selection *sel, size_t size, unsigned *cap) {
+    if(sel->size_count == OPTIONS_MAX_SIZES)
+        return -1;
+
+    if(sel->size_count == *cap) {
+        size_t *grown = realloc(sel->sizes, (*cap ? 2 * *cap : 64) * sizeof(size_t));
+        if(!grown)
+            return -1;
+
+        sel->sizes = grown;
+        *cap = *cap ? 2 * *cap : 64;
+    }
+
+    sel->sizes[sel->size_count++] = size;
+    return 0;
+}
+
+// Unsigned number (decimal, 0x hex), optionally with a k or m suffix
+int bench_parse_size(const char *s, char **end, size_t *out) {
+    unsigned long long v;
+
+    if(!isdigit((unsigned char)*s))
+        return -1;
+
+    v = strtoull(s, end, 0);
+    if(**end == 'k' || **end == 'K') {
+        v <<= 10;
+        (*end)++;
+    }
+    else if(**end == 'm' || **end == 'M') {
+        v <<= 20;
+        (*end)++;
+    }
+
+    *out = (size_t)v;
+    return 0;
+}
+
+int bench_parse_sizes(const char *spec, bench_selection *sel) {
+    size_t a, b, c;
+    unsigned cap = 0, k;
+    char *end;
+
+    free(sel->sizes);
+    sel->sizes = NULL;
+    sel->size_count = 0;
+
+    if(!strncmp(spec, "lin:", 4) || !strncmp(spec, "log:", 4)) {
+        int log_spaced = spec[1] == 'o';
+
+        c = log_spaced ? 4 : 1; // steps per doubling, or the linear step
+
+        if(bench_parse_size(spec + 4, &end, &a) || *end != ':' || bench_parse_size(end + 1, &end, &b))
+            return -1;
+        if(*end == ':' && bench_parse_size(end + 1, &end, &c))
+            return -1;
+        if(*end || a > b || !c || (log_spaced && !a))
+            return -1;
+
+        if(!log_spaced) {
+            for(; a <= b; a += c) {
+                if(append_size(sel, a, &cap))
+                    return -1;
+                if(b - a < c)
+                    break;
+            }
+
+            return 0;
+        }
+
+        // start * 2^(k / c), skipping sizes that round to the previous one
+        for(k = 0; ; k++) {
+            double v = (double)a * pow(2.0, (double)k / (double)c);
+            size_t size = (size_t)(v + 0.5);
+
+            if(v > (double)b)
+                break;
+            if(sel->size_count && size == sel->sizes[sel->size_count - 1])
+                continue;
+            if(append_size(sel, size, &cap))
+                return -1;
+        }
+
+        return 0;
+    }
+
+    if(!strncmp(spec, "list:", 5))
+        spec += 5;
+
+    do {
+        if(bench_parse_size(spec, &end, &a) || append_size(sel, a, &cap))
+            return -1;
+        spec = end + 1;
+    } while(*end == ',');
+
+    return *end ? -1 : 0;
+}
+
+int bench_parse_aligns(const char *spec, bench_selection *sel) {
+    unsigned count = 1;
+    const char *p;
+    char *end;
+
+    for(p = spec; *p; p++)
+        count += *p == ',';
+
+    free(sel->aligns);
+    sel->aligns = malloc(count * sizeof(*sel->aligns));
+    sel->align_count = 0;
+    if(!sel->aligns)
+        return -1;
+
+    do {
+        unsigned long s, d;
+
+        if(!isdigit((unsigned char)*spec))
+            return -1;
+
+        s = d = strtoul(spec, &end, 10);
+        if(*end == ':') {
+            if(!isdigit((unsigned char)end[1]))
+                return -1;
+            d = strtoul(end + 1, &end, 10);
+        }
+
+        if(s >= BENCH_MAX_ALIGN || d >= BENCH_MAX_ALIGN)
+            return -1;
+
+        sel->aligns[sel->align_count].src = (unsigned)s;
+        sel->aligns[sel->align_count].dst = (unsigned)d;
+        sel->align_count++;
+        spec = end + 1;
+    } while(*end == ',');
+
+    return *end ? -1 : 0;
+}
+
+int bench_parse_ops(const char *spec, bench_selection *sel) {
+    sel->ops = 0;
+
+    while(*spec) {
+        size_t len = strcspn(spec, ",");
+        unsigned o;
+
+        for(o = 0; o < sizeof(all_ops) / sizeof(all_ops[0]); o++) {
+            const char *name = bench_op_name(all_ops[o]);
+
+            if(strlen(name) == len && !strncmp(spec, name, len))
+                break;
+        }
+
+        if(o == sizeof(all_ops) / sizeof(all_ops[0]))
+            return -1;
+
+        sel->ops |= 1u << all_ops[o];
+        spec += len + (spec[len] == ',');
+    }
+
+    return sel->ops ? 0 : -1;
+}
+
+int bench_parse_format(const char *spec, bench_config *cfg) {
+    if(!strcmp(spec, "wide"))
+        cfg->format = BENCH_FORMAT_WIDE;
+    else if(!strcmp(spec, "long"))
+        cfg->format = BENCH_FORMAT_LONG;
+    else if(!strcmp(spec, "json"))
+        cfg->format = BENCH_FORMAT_JSON;
+    else
+        return -1;
+
+    return 0;
+}
+
+int bench_parse_cache(const char *spec, bench_config *cfg) {
+    static const bench_cache states[] = { BENCH_CACHE_WARM, BENCH_CACHE_COLD, BENCH_CACHE_DST_COLD };
+    unsigned c;
+
+    for(c = 0; c < sizeof(states) / sizeof(states[0]); c++) {
+        if(!strcmp(spec, bench_cache_name(states[c]))) {
+            cfg->cache = states[c];
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+// Case-insensitive compare of len bytes of a with all of b
+static int token_is(const char *a, size_t len, const char *b) {
+    if(strlen(b) != len)
+        return 0;
+
+    while(len--) {
+        if(tolower((unsigned char)*a++) != tolower((unsigned char)*b++))
+            return 0;
+    }
+
+    return 1;
+}
+
+int bench_impl_selected(const bench_selection *sel, const bench_impl *impl) {
+    const char *filter = sel->impls;
+    const char *suffix = strchr(impl->name, '_');
+    int is_libc = impl == bench_impls(impl->op);
+
+    if(!filter)
+        return 1;
+
+    while(*filter) {
+        size_t len = strcspn(filter, ",");
+
+        if(token_is(filter, len, impl->name) || (suffix && token_is(filter, len, suffix + 1))
+            || (is_libc && token_is(filter, len, "libc")))
+            return 1;
+
+        filter += len + (filter[len] == ',');
+    }
+
+    return 0;
+}
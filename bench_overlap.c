@@ -0,0 +1,73 @@
+// memmove overlap-distance sweep
+//
+// Source and destination live in one buffer, `Distance` bytes apart. Forward
+// moves have the destination below the source, backward moves above it, which
+// is the case where direction matters. Distances run 1..64 byte by byte, where
+// the stride and direction choices in memmove.c matter most, then in powers of
+// two up to twice the size, past the point where the ranges stop overlapping.
+// bench_run() checks every move against libc memmove into a separate buffer.
+// The alignment columns are the offsets of source and destination from a
+// 32-byte boundary.
+
+#include <stdio.h>
+
+#include "bench.h"
+
+#define OVERLAP_MAX_SIZE 4096
+
+#define OVERLAP_DENSE_MAX 64
+
+static const size_t overlap_sizes[] = { 16, 64, 256, 1024, 4096 };
+
+// Room for the destination up to 2 sizes on either side of the source
+static uint8_t overlap_buf[5 * OVERLAP_MAX_SIZE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+// Next distance after dist in the schedule, 0 once past both the dense
+// range and 2 * size
+static long next_distance(long dist, long size) {
+    if(dist < OVERLAP_DENSE_MAX)
+        dist++;
+    else
+        dist *= 2;
+
+    return dist <= 2 * size || dist <= OVERLAP_DENSE_MAX ? dist : 0;
+}
+
+void bench_overlap_sweep(const bench_config *cfg) {
+    uint8_t *base = overlap_buf + BENCH_GUARD + 2 * OVERLAP_MAX_SIZE;
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    bench_align align;
+    bench_extra extra = { 2, 3, { "Direction", "Distance", "Overlap" } };
+    unsigned i, dir;
+    long dist;
+
+    bench_result_header(cfg->format, &extra);
+
+    for(i = 0; i < sizeof(overlap_sizes) / sizeof(overlap_sizes[0]); i++) {
+        long n = (long)overlap_sizes[i];
+
+        args.len = n;
+        args.src = base;
+
+        for(impl = bench_impls(BENCH_OP_MEMMOVE); impl->name; impl++) {
+            for(dir = 0; dir < 2; dir++) {
+                for(dist = 1; dist; dist = next_distance(dist, n)) {
+                    // Forward: destination below the source
+                    args.dst = dir ? base + dist : base - dist;
+
+                    bench_run(cfg, impl, &args, &stats);
+
+                    align.src = (uintptr_t)args.src % BENCH_MAX_ALIGN;
+                    align.dst = (uintptr_t)args.dst % BENCH_MAX_ALIGN;
+                    bench_extra_set(&extra, 0, "%s", dir ? "backward" : "forward");
+                    bench_extra_set(&extra, 1, "%ld", dist);
+                    bench_extra_set(&extra, 2, "%d", dist < n);
+                    bench_result_print(cfg->format, cfg, BENCH_OP_MEMMOVE, impl->name, args.len, &align, &stats,
+                        &extra);
+                }
+            }
+        }
+    }
+}
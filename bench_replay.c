@@ -0,0 +1,442 @@
+// Size-distribution replay
+//
+// The sweeps call sizes in increasing order, so the size dispatch in
+// memcpy_moop/memset_moop is perfectly predicted. This mode times a stream of
+// calls whose operations, sizes and alignments are drawn from a distribution
+// instead, and reports what the whole mix costs with each implementation.
+//
+// A distribution is a file, or one of replay_presets below, with one entry per
+// line (# starts a comment):
+//
+//   trace                        optional, before any entry
+//   OP SIZE[-MAX] ALIGN[@DELTA] [WEIGHT]
+//
+// OP is memcpy, memmove or memset. The size is drawn uniformly from SIZE to
+// MAX, k/m suffixes allowed. ALIGN is the SRC:DST offsets from a 32-byte
+// boundary, or N for N:N (memset only uses DST). WEIGHT defaults to 1.
+//
+// A memmove with @DELTA moves within one buffer, the destination DELTA bytes
+// after the source (before it if negative), so the ranges overlap whenever
+// |DELTA| is below the size. ALIGN is then only the source offset N. Without
+// it, memmove copies between the two buffers like memcpy, a case
+// memmove_moop passes straight on to memcpy_moop.
+//
+// By default the file is a histogram: each call picks an entry at random in
+// proportion to the weights. With "trace" the entries are replayed in file
+// order, WEIGHT calls each, from the top again until the stream is full.
+//
+// Every call goes to the same pair of heap buffers, so the stream runs warm.
+// The overlapping memmoves work in the destination buffer, past the room the
+// most negative DELTA needs.
+// Each implementation family (libc, moop, fast, auto - the three bench_impls()
+// tables list them in the same order) runs the stream once and is checked
+// against libc, then -w untimed and -r timed passes follow. Results are
+// "replay" rows keyed by the Distribution (the file's name without its
+// directory), with the mean call size as Bytes.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "bench.h"
+#include "platform.h"
+
+#define REPLAY_LINE_MAX 256
+#define REPLAY_MAX_DELTA (1 << 20) // keeps the move window within reason
+
+typedef struct {
+    bench_op op;
+    size_t lo;
+    size_t hi;
+    unsigned src;
+    unsigned dst;
+    long delta; // memmove within one buffer, destination minus source; 0 for two buffers
+    unsigned weight;
+} replay_entry;
+
+typedef struct {
+    bench_op op;
+    size_t len;
+    unsigned src;
+    unsigned dst;
+    long delta;
+} replay_call;
+
+static const struct {
+    const char *name;
+    const char *text;
+} replay_presets[] = {
+    { "small",
+        "# Mostly under 64 bytes: struct copies, short strings, small clears\n"
+        "memcpy 1-16 0:0 30\n"
+        "memcpy 17-63 0:0 30\n"
+        "memcpy 1-63 1:3 10\n"
+        "memmove 1-63 0@8 3\n"
+        "memmove 1-63 0@-8 2\n"
+        "memset 1-63 0 15\n"
+        "memcpy 64-256 0:0 8\n"
+        "memcpy 257-4k 0:0 2\n" },
+    { "packets",
+        "# Network traffic: headers, minimum-size frames and ACKs, MTU-sized\n"
+        "# payloads, with the IP header 2 bytes into the buffer\n"
+        "memcpy 14-54 2:0 30\n"
+        "memcpy 60-64 2:2 25\n"
+        "memcpy 576 2:2 5\n"
+        "memcpy 1400-1514 2:2 35\n"
+        "memset 64 0 5\n" },
+    { "textures",
+        "# Texture and vertex uploads: 16-bit power-of-two textures from 32x32\n"
+        "# to 512x512, vertex buffers, and buffer clears, all 32-byte aligned\n"
+        "memcpy 2k 0:0 10\n"
+        "memcpy 8k 0:0 20\n"
+        "memcpy 32k 0:0 30\n"
+        "memcpy 128k 0:0 25\n"
+        "memcpy 512k 0:0 5\n"
+        "memcpy 1k-16k 0:0 10\n"
+        "memset 8k-32k 0 5\n" },
+};
+
+static uint32_t replay_rng = 0x9e3779b9;
+
+static uint32_t replay_random(void) {
+    uint32_t x = replay_rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return replay_rng = x;
+}
+
+// One line into *e. Returns 1 for an entry, 0 for a blank or comment line,
+// 2 for "trace" and -1 for anything malformed.
+static int replay_parse_line(char *line, replay_entry *e) {
+    static const bench_op ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+    char *word, *end;
+    unsigned long s, d;
+    size_t delta;
+    unsigned o;
+
+    line[strcspn(line, "#\r\n")] = '\0';
+
+    word = strtok(line, " \t");
+    if(!word)
+        return 0;
+    if(!strcmp(word, "trace"))
+        return strtok(NULL, " \t") ? -1 : 2;
+
+    for(o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        if(!strcmp(word, bench_op_name(ops[o])))
+            break;
+    }
+    if(o == sizeof(ops) / sizeof(ops[0]))
+        return -1;
+    e->op = ops[o];
+
+    word = strtok(NULL, " \t");
+    if(!word || bench_parse_size(word, &end, &e->lo))
+        return -1;
+    e->hi = e->lo;
+    if(*end == '-' && bench_parse_size(end + 1, &end, &e->hi))
+        return -1;
+    if(*end || e->hi < e->lo)
+        return -1;
+
+    word = strtok(NULL, " \t");
+    if(!word || !isdigit((unsigned char)*word))
+        return -1;
+    s = d = strtoul(word, &end, 10);
+    if(*end == ':') {
+        if(!isdigit((unsigned char)end[1]))
+            return -1;
+        d = strtoul(end + 1, &end, 10);
+    }
+    e->delta = 0;
+    if(*end == '@') {
+        int back = end[1] == '-';
+
+        if(e->op != BENCH_OP_MEMMOVE || strchr(word, ':') || bench_parse_size(end + 1 + back, &end, &delta))
+            return -1;
+        if(!delta || delta > REPLAY_MAX_DELTA)
+            return -1;
+        e->delta = back ? -(long)delta : (long)delta;
+    }
+    if(*end || s >= BENCH_MAX_ALIGN || d >= BENCH_MAX_ALIGN)
+        return -1;
+    e->src = (unsigned)s;
+    e->dst = (unsigned)d;
+
+    e->weight = 1;
+    word = strtok(NULL, " \t");
+    if(word) {
+        e->weight = (unsigned)strtoul(word, &end, 10);
+        if(*end || !e->weight || strtok(NULL, " \t"))
+            return -1;
+    }
+
+    return 1;
+}
+
+// Entries of the preset called name, or else of the file at that path, into
+// *entries, which grows as needed (a memtrace dump has an entry per call site,
+// size bucket and alignment pair). Returns the entry count, 0 on any error
+// (already reported). Free *entries either way.
+static unsigned replay_load(const char *name, replay_entry **entries, int *trace) {
+    char line[REPLAY_LINE_MAX];
+    const char *text = NULL;
+    unsigned count = 0, capacity = 0, number = 0, p;
+    int bad = 0;
+    FILE *f = NULL;
+
+    for(p = 0; p < sizeof(replay_presets) / sizeof(replay_presets[0]); p++) {
+        if(!strcmp(name, replay_presets[p].name))
+            text = replay_presets[p].text;
+    }
+
+    if(!text && !(f = fopen(name, "r"))) {
+        fprintf(stderr, "bench: no preset or file called %s\n", name);
+        return 0;
+    }
+
+    *trace = 0;
+
+    for(;;) {
+        int r;
+
+        if(text) {
+            size_t len = strcspn(text, "\n");
+
+            if(!*text)
+                break;
+
+            snprintf(line, sizeof(line), "%.*s", (int)len, text);
+            text += len + (text[len] == '\n');
+        }
+        else if(!fgets(line, sizeof(line), f))
+            break;
+
+        if(count == capacity) {
+            replay_entry *grown;
+
+            capacity = capacity ? 2 * capacity : 64;
+            grown = realloc(*entries, capacity * sizeof(replay_entry));
+            if(!grown) {
+                fprintf(stderr, "bench: out of memory\n");
+                abort();
+            }
+            *entries = grown;
+        }
+
+        number++;
+        r = replay_parse_line(line, &(*entries)[count]);
+
+        if(r < 0 || (r == 2 && count)) {
+            fprintf(stderr, "bench: %s:%u: bad distribution entry\n", name, number);
+            bad = 1;
+            count = 0;
+            break;
+        }
+
+        if(r == 2)
+            *trace = 1;
+        else if(r == 1)
+            count++;
+    }
+
+    if(f)
+        fclose(f);
+
+    if(!count && !bad)
+        fprintf(stderr, "bench: %s has no entries\n", name);
+
+    return count;
+}
+
+static void replay_stream(const replay_entry *entries, unsigned count, int trace, replay_call *calls, unsigned n) {
+    uint64_t total = 0, *cumulative = malloc(count * sizeof(uint64_t));
+    unsigned i, k = 0, left = 0;
+
+    if(!cumulative) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    for(i = 0; i < count; i++)
+        cumulative[i] = total += entries[i].weight;
+
+    for(i = 0; i < n; i++) {
+        const replay_entry *e;
+
+        if(trace) {
+            if(!left)
+                left = entries[k].weight;
+            e = &entries[k];
+            if(!--left)
+                k = (k + 1) % count;
+        }
+        else {
+            uint64_t r = (((uint64_t)replay_random() << 32) | replay_random()) % total;
+            unsigned lo = 0, hi = count - 1;
+
+            // First entry whose cumulative weight is above r
+            while(lo < hi) {
+                unsigned mid = (lo + hi) / 2;
+
+                if(cumulative[mid] > r)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+
+            e = &entries[lo];
+        }
+
+        calls[i].op = e->op;
+        calls[i].len = e->lo + (e->hi > e->lo ? replay_random() % (e->hi - e->lo + 1) : 0);
+        calls[i].src = e->src;
+        calls[i].dst = e->dst;
+        calls[i].delta = e->delta;
+    }
+
+    free(cumulative);
+}
+
+// impls is indexed by bench_op. memset calls fill with the low byte of the
+// call index, so a call that goes to the wrong place shows up in the check.
+// Overlapping memmoves start at dst + move.
+static void replay_run(const bench_impl * const *impls, const replay_call *calls, unsigned n,
+    const uint8_t *src, uint8_t *dst, size_t move) {
+    unsigned i;
+
+    for(i = 0; i < n; i++) {
+        const replay_call *c = &calls[i];
+
+        if(c->op == BENCH_OP_MEMSET)
+            impls[c->op]->set(dst + c->dst, (int)(i & 0xff), c->len);
+        else if(c->delta) {
+            uint8_t *from = dst + move + c->src;
+
+            impls[c->op]->copy(from + c->delta, from, c->len);
+        }
+        else
+            impls[c->op]->copy(dst + c->dst, src + c->src, c->len);
+    }
+}
+
+typedef struct {
+    const bench_impl * const *impls;
+    const replay_call *calls;
+    unsigned n;
+    const uint8_t *src;
+    uint8_t *dst;
+    size_t move;
+} replay_pass;
+
+// bench_batch_fn over whole passes through the stream
+static void replay_passes(void *ctx, unsigned count) {
+    const replay_pass *pass = ctx;
+
+    while(count--)
+        replay_run(pass->impls, pass->calls, pass->n, pass->src, pass->dst, pass->move);
+}
+
+static void replay_fill(uint8_t *p, size_t len) {
+    size_t i;
+
+    for(i = 0; i < len; i++)
+        p[i] = (uint8_t)(i * 31 + 7);
+}
+
+void bench_replay(const bench_config *cfg, const char *name, unsigned n) {
+    replay_entry *entries = NULL;
+    replay_call *calls = malloc(n * sizeof(replay_call));
+    double *samples = malloc(cfg->repetitions * sizeof(double));
+    size_t max_size = 0, max_back = 0, max_ahead = 0, move, window;
+    double bytes = 0;
+    unsigned count, family, i;
+    uint8_t *src, *dst, *ref;
+    void *src_raw, *dst_raw, *ref_raw;
+    bench_align align = { 0, 0 };
+    bench_extra extra = { 1, 3, { "Distribution", "Bytes_Per_Call", "MB_s" } };
+    const char *base = strrchr(name, '/');
+    int trace;
+
+    if(!calls || !samples) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    count = replay_load(name, &entries, &trace);
+    if(!count || !n) {
+        free(entries);
+        free(calls);
+        free(samples);
+        return;
+    }
+
+    for(i = 0; i < count; i++) {
+        if(entries[i].hi > max_size)
+            max_size = entries[i].hi;
+        if(entries[i].delta < 0 && (size_t)-entries[i].delta > max_back)
+            max_back = (size_t)-entries[i].delta;
+        if(entries[i].delta > 0 && (size_t)entries[i].delta > max_ahead)
+            max_ahead = (size_t)entries[i].delta;
+    }
+
+    // Whole cache lines below the moves, so their source offsets still hold
+    move = (max_back + BENCH_MAX_ALIGN - 1) & ~(size_t)(BENCH_MAX_ALIGN - 1);
+
+    replay_stream(entries, count, trace, calls, n);
+    for(i = 0; i < n; i++)
+        bytes += (double)calls[i].len;
+
+    window = move + max_ahead + max_size + BENCH_MAX_ALIGN + BENCH_GUARD;
+    src = bench_alloc(max_size + BENCH_MAX_ALIGN, &src_raw);
+    dst = bench_alloc(window, &dst_raw);
+    ref = bench_alloc(window, &ref_raw);
+    replay_fill(src, max_size + BENCH_MAX_ALIGN);
+
+    bench_extra_set(&extra, 0, "%s", base ? base + 1 : name);
+    bench_extra_set(&extra, 1, "%.1f", bytes / n);
+    bench_result_header(cfg->format, &extra);
+
+    for(family = 0; bench_impls(BENCH_OP_MEMCPY)[family].name; family++) {
+        const bench_impl *impls[] = {
+            &bench_impls(BENCH_OP_MEMCPY)[family],
+            &bench_impls(BENCH_OP_MEMMOVE)[family],
+            &bench_impls(BENCH_OP_MEMSET)[family],
+        };
+        const char *label = family ? strchr(impls[0]->name, '_') + 1 : "Libc";
+        replay_pass pass = { impls, calls, n, src, dst, move };
+        bench_stats stats;
+
+        // Family 0 is libc, whose result is the reference for the rest
+        replay_fill(dst, window);
+        replay_run(impls, calls, n, src, dst, move);
+        if(!family)
+            memcpy(ref, dst, window);
+        else if(memcmp(dst, ref, window)) {
+            fprintf(stderr, "bench: %s replay of %s differs from libc\n", label, name);
+            abort();
+        }
+
+        replay_passes(&pass, cfg->warmup);
+
+        for(i = 0; i < cfg->repetitions; i++)
+            samples[i] = bench_time_batch(replay_passes, &pass, 1) / n;
+
+        bench_stats_compute(samples, cfg->repetitions, n, cfg->outlier_z, &stats);
+        stats.cycles = stats.median * platform_cpu_mhz() / 1000.0;
+
+        bench_extra_set(&extra, 2, "%.1f", stats.median > 0 ? bytes / n * 1000.0 / stats.median : 0.0);
+        bench_result_print(cfg->format, cfg, BENCH_OP_REPLAY, label, (size_t)(bytes / n + 0.5), &align, &stats,
+            &extra);
+    }
+
+    free(entries);
+    free(calls);
+    free(samples);
+    free(src_raw);
+    free(dst_raw);
+    free(ref_raw);
+}
@@ -0,0 +1,242 @@
+// Long-format result schema
+//
+// One row (CSV) or object (JSON lines) per measurement, carrying everything
+// needed to compare it with a run from another build or machine:
+//
+//   Operation, Implementation  what was timed
+//   Bytes, Src_Align, Dst_Align  call size and buffer offsets from 32 bytes
+//   Cache                      warm, cold or dst-cold
+//   <Mode keys>                what else tells a mode's rows apart, e.g.
+//                              Direction and Distance in overlap
+//   Warmup, Repetitions        calls before timing, timed samples requested
+//   Samples, Rejected          samples kept and dropped as outliers
+//   Batch                      calls per sample
+//   Min_Ns .. Stddev_Ns        per-call statistics of the kept samples, in ns
+//   Cycles                     median in CPU cycles, 0 if the clock is unknown
+//   <Event>_Per_Byte           hardware counters, empty unless counted (-e)
+//   <Mode values>              figures derived from the row, e.g. MB_s
+//   Platform, Cpu_Mhz          platform_name() and platform_cpu_mhz()
+//   Commit, Compiler, Flags    build metadata
+//
+// The mode columns are the bench_extra a mode passes, none for sweep. JSON
+// uses the same fields with lowercase keys, mode keys as strings, and leaves
+// uncounted events out. bench_compare.c reads both, and matches rows on
+// everything up to the mode keys.
+//
+// Commit and Flags come from the Makefile, which rebuilds this file every time
+// so they can't go stale. Builds that don't pass them report "unknown".
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+
+#include "bench.h"
+#include "platform.h"
+
+#ifndef MEMBENCH_COMMIT
+#define MEMBENCH_COMMIT "unknown"
+#endif
+
+#ifndef MEMBENCH_CFLAGS
+#define MEMBENCH_CFLAGS "unknown"
+#endif
+
+#if defined(__clang__)
+#define MEMBENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define MEMBENCH_COMPILER "gcc " __VERSION__
+#else
+#define MEMBENCH_COMPILER "unknown"
+#endif
+
+// Quoted only if it has to be
+static void print_csv_field(const char *s) {
+    const char *c;
+
+    for(c = s; *c && *c != ',' && *c != '"' && *c != '\n'; c++)
+        ;
+
+    if(!*c) {
+        printf(",%s", s);
+        return;
+    }
+
+    printf(",\"");
+    for(c = s; *c; c++) {
+        if(*c == '"')
+            putchar('"');
+        putchar(*c);
+    }
+    putchar('"');
+}
+
+static void print_json_field(const char *key, const char *s) {
+    printf(",\"%s\":\"", key);
+    for(; *s; s++) {
+        if(*s == '"' || *s == '\\')
+            putchar('\\');
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+static void print_json_key(const char *name) {
+    printf(",\"");
+    for(; *name; name++)
+        putchar(tolower((unsigned char)*name));
+    printf("\":");
+}
+
+static const char * skip_digits(const char *v) {
+    while(isdigit((unsigned char)*v))
+        v++;
+
+    return v;
+}
+
+// A JSON number: optional minus, integer part without leading zeros, then an
+// optional fraction and exponent. strtod would also take inf, nan and hex.
+static int json_number(const char *v) {
+    const char *p;
+
+    if(*v == '-')
+        v++;
+    if(*v == '0')
+        v++;
+    else if(isdigit((unsigned char)*v))
+        v = skip_digits(v);
+    else
+        return 0;
+
+    if(*v == '.') {
+        p = skip_digits(++v);
+        if(p == v)
+            return 0;
+        v = p;
+    }
+
+    if(*v == 'e' || *v == 'E') {
+        v++;
+        if(*v == '+' || *v == '-')
+            v++;
+        p = skip_digits(v);
+        if(p == v)
+            return 0;
+        v = p;
+    }
+
+    return !*v;
+}
+
+// Mode columns first..last-1: CSV fields, or JSON members with keys always
+// strings and the rest bare if they are numbers
+static void print_extra(bench_format format, const bench_extra *extra, unsigned first, unsigned last) {
+    unsigned i;
+
+    for(i = first; extra && i < last; i++) {
+        const char *v = extra->values[i];
+
+        if(format != BENCH_FORMAT_JSON) {
+            print_csv_field(v);
+            continue;
+        }
+
+        print_json_key(extra->names[i]);
+        if(i >= extra->keys && json_number(v))
+            printf("%s", v);
+        else {
+            putchar('"');
+            for(; *v; v++) {
+                if(*v == '"' || *v == '\\')
+                    putchar('\\');
+                putchar(*v);
+            }
+            putchar('"');
+        }
+    }
+}
+
+void bench_extra_set(bench_extra *extra, unsigned i, const char *fmt, ...) {
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(extra->values[i], BENCH_EXTRA_LEN, fmt, ap);
+    va_end(ap);
+}
+
+void bench_result_header(bench_format format, const bench_extra *extra) {
+    unsigned e, i;
+
+    if(format == BENCH_FORMAT_JSON)
+        return;
+
+    printf("Operation,Implementation,Bytes,Src_Align,Dst_Align,Cache");
+    for(i = 0; extra && i < extra->keys; i++)
+        printf(",%s", extra->names[i]);
+    printf(",Warmup,Repetitions,Samples,Rejected,Batch,Min_Ns,Median_Ns,Mean_Ns,P99_Ns,Stddev_Ns,Cycles");
+    for(e = 0; e < COUNTER_EVENTS; e++)
+        printf(",%s_Per_Byte", counter_event_name(e));
+    for(i = extra ? extra->keys : 0; extra && i < extra->count; i++)
+        printf(",%s", extra->names[i]);
+    printf(",Platform,Cpu_Mhz,Commit,Compiler,Flags\n");
+}
+
+void bench_result_print(bench_format format, const bench_config *cfg, bench_op op, const char *impl,
+    size_t len, const bench_align *align, const bench_stats *stats, const bench_extra *extra) {
+    unsigned keys = extra ? extra->keys : 0, count = extra ? extra->count : 0;
+    unsigned e;
+
+    if(format != BENCH_FORMAT_JSON) {
+        printf("%s,%s,%u,%u,%u,%s", bench_op_name(op), impl, (unsigned)len, align->src, align->dst,
+            bench_cache_name(cfg->cache));
+        print_extra(format, extra, 0, keys);
+        printf(",%u,%u,%u,%u,%u,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g",
+            cfg->warmup, cfg->repetitions, stats->samples, stats->rejected, stats->batch,
+            stats->min, stats->median, stats->mean, stats->p99, stats->stddev, stats->cycles);
+
+        for(e = 0; e < COUNTER_EVENTS; e++) {
+            if(stats->counted & (1u << e))
+                printf(",%.6g", stats->per_byte[e]);
+            else
+                printf(",");
+        }
+
+        print_extra(format, extra, keys, count);
+        print_csv_field(platform_name());
+        printf(",%.0f", platform_cpu_mhz());
+        print_csv_field(MEMBENCH_COMMIT);
+        print_csv_field(MEMBENCH_COMPILER);
+        print_csv_field(MEMBENCH_CFLAGS);
+        printf("\n");
+        return;
+    }
+
+    printf("{\"operation\":\"%s\",\"implementation\":\"%s\",\"bytes\":%u,\"src_align\":%u,\"dst_align\":%u,"
+        "\"cache\":\"%s\"", bench_op_name(op), impl, (unsigned)len, align->src, align->dst,
+        bench_cache_name(cfg->cache));
+    print_extra(format, extra, 0, keys);
+    printf(",\"warmup\":%u,\"repetitions\":%u,\"samples\":%u,\"rejected\":%u,\"batch\":%u,"
+        "\"min_ns\":%.6g,\"median_ns\":%.6g,\"mean_ns\":%.6g,\"p99_ns\":%.6g,\"stddev_ns\":%.6g,\"cycles\":%.6g",
+        cfg->warmup, cfg->repetitions, stats->samples, stats->rejected, stats->batch,
+        stats->min, stats->median, stats->mean, stats->p99, stats->stddev, stats->cycles);
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        const char *c;
+
+        if(!(stats->counted & (1u << e)))
+            continue;
+
+        printf(",\"");
+        for(c = counter_event_name(e); *c; c++)
+            putchar(tolower((unsigned char)*c));
+        printf("_per_byte\":%.6g", stats->per_byte[e]);
+    }
+
+    print_extra(format, extra, keys, count);
+    print_json_field("platform", platform_name());
+    printf(",\"cpu_mhz\":%.0f", platform_cpu_mhz());
+    print_json_field("commit", MEMBENCH_COMMIT);
+    print_json_field("compiler", MEMBENCH_COMPILER);
+    print_json_field("flags", MEMBENCH_CFLAGS);
+    printf("}\n");
+}
@@ -0,0 +1,183 @@
+// Bandwidth roofline
+//
+// STREAM-style reference loops that do nothing but load, store or copy at one
+// access width (8, 16, 32 and 64-bit, eight per iteration, from the kernel
+// family in memkernels.c) or a 32-byte line at a time (movca.l for the stores).
+// Each runs once with the working set inside the operand cache and once with
+// it well outside, and the fastest loop of each operation in each regime is
+// taken as that operation's peak.
+//
+// The library implementations and the fixed-width kernels then run on the same
+// buffers, and Peak_Pct rates every row against its peak: memcpy and memmove
+// against the best copy loop, memset against the best store loop. Loop rows
+// are rated the same way, so the best loop of each operation reads 100.
+//
+// Regime is "in" or "out" of cache; the Cache column is the -c state as in
+// every mode.
+//
+// Out of cache is only out of cache if out_size is bigger than every cache
+// level; on a host pass a few times the last-level cache size.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+
+// Source and destination together fill half the 16 KB operand cache
+#define ROOFLINE_IN_SIZE 4096
+
+#define ROOFLINE_BLOCK 64 // largest loop block, every size is a multiple of it
+
+// The benchmark passes lengths in bytes, the loops count blocks
+#define ROOFLINE_WRAPPERS(w) \
+    static void * roofline_read_##w(void *dest, const void *src, size_t n) { \
+        memread_##w##bit_x8(src, n / w); \
+        return dest; \
+    } \
+    static void * roofline_write_##w(void *dest, int c, size_t n) { \
+        return memset_##w##bit_x8(dest, (uint8_t)c * 0x01010101u, n / w); \
+    } \
+    static void * roofline_copy_##w(void *dest, const void *src, size_t n) { \
+        return memcpy_##w##bit_x8(dest, src, n / w); \
+    }
+
+ROOFLINE_WRAPPERS(8)
+ROOFLINE_WRAPPERS(16)
+ROOFLINE_WRAPPERS(32)
+ROOFLINE_WRAPPERS(64)
+
+static void * roofline_read_line(void *dest, const void *src, size_t n) {
+    memread_64bit_x4(src, n / 32);
+    return dest;
+}
+
+static void * roofline_write_line(void *dest, int c, size_t n) {
+    return memset_64bit_32Bytes_movca(dest, (uint8_t)c * 0x01010101u, n / 32);
+}
+
+static void * roofline_copy_line(void *dest, const void *src, size_t n) {
+    return memcpy_64bit_32Bytes_movca(dest, src, n / 32);
+}
+
+static void * roofline_memcpy_32bit_16Bytes(void *dest, const void *src, size_t n) {
+    return memcpy_32bit_16Bytes(dest, src, n / 16);
+}
+
+static void * roofline_memcpy_64bit_32Bytes(void *dest, const void *src, size_t n) {
+    return memcpy_64bit_32Bytes(dest, src, n / 32);
+}
+
+static void * roofline_memset_64bit(void *dest, int c, size_t n) {
+    return memset_64bit(dest, (uint8_t)c * 0x01010101u, n / 8);
+}
+
+#define ROOFLINE_LOOP_ENTRIES(w) \
+    { "Read_" #w "bit", BENCH_OP_READ, roofline_read_##w, NULL, -1 }, \
+    { "Write_" #w "bit", BENCH_OP_MEMSET, NULL, roofline_write_##w, -1 }, \
+    { "Copy_" #w "bit", BENCH_OP_MEMCPY, roofline_copy_##w, NULL, -1 },
+
+static const bench_impl roofline_loops[] = {
+    ROOFLINE_LOOP_ENTRIES(8)
+    ROOFLINE_LOOP_ENTRIES(16)
+    ROOFLINE_LOOP_ENTRIES(32)
+    ROOFLINE_LOOP_ENTRIES(64)
+    { "Read_Line", BENCH_OP_READ, roofline_read_line, NULL, -1 },
+    { "Write_Line", BENCH_OP_MEMSET, NULL, roofline_write_line, -1 },
+    { "Copy_Line", BENCH_OP_MEMCPY, roofline_copy_line, NULL, -1 },
+};
+
+#define ROOFLINE_LOOPS (sizeof(roofline_loops) / sizeof(roofline_loops[0]))
+
+// Rated alongside the bench_impls() tables
+static const bench_impl roofline_kernels[] = {
+    { "Memcpy_32bit_16Bytes", BENCH_OP_MEMCPY, roofline_memcpy_32bit_16Bytes, NULL, -1 },
+    { "Memcpy_64bit_32Bytes", BENCH_OP_MEMCPY, roofline_memcpy_64bit_32Bytes, NULL, -1 },
+    { "Memset_64bit", BENCH_OP_MEMSET, NULL, roofline_memset_64bit, -1 },
+    { NULL },
+};
+
+static const bench_op roofline_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+// MB_s from the median, 10^6 bytes per second
+#define ROOFLINE_COLUMNS { 2, 4, { "Role", "Regime", "MB_s", "Peak_Pct" } }
+
+static double roofline_rate(const bench_stats *stats, size_t len) {
+    return stats->median > 0 ? (double)len * 1000.0 / stats->median : 0.0;
+}
+
+// memmove does a copy's work, so it is rated against the copy peak
+static bench_op roofline_class(bench_op op) {
+    return op == BENCH_OP_MEMMOVE ? BENCH_OP_MEMCPY : op;
+}
+
+static void roofline_print(const bench_config *cfg, const char *role, const bench_impl *impl, const char *regime,
+    const bench_args *args, const bench_stats *stats, const double *peak) {
+    static const bench_align align = { 0, 0 };
+    bench_extra extra = ROOFLINE_COLUMNS;
+    double rate = roofline_rate(stats, args->len);
+    double best = peak[roofline_class(impl->op)];
+
+    bench_extra_set(&extra, 0, "%s", role);
+    bench_extra_set(&extra, 1, "%s", regime);
+    bench_extra_set(&extra, 2, "%.1f", rate);
+    bench_extra_set(&extra, 3, "%.1f", best > 0 ? 100.0 * rate / best : 0.0);
+    bench_result_print(cfg->format, cfg, impl->op, impl->name, args->len, &align, stats, &extra);
+}
+
+static void roofline_regime(const bench_config *cfg, const bench_args *args, const char *regime) {
+    bench_stats stats[ROOFLINE_LOOPS];
+    double peak[BENCH_OP_READ + 1] = { 0 };
+    const bench_impl *impl;
+    unsigned i, o;
+
+    for(i = 0; i < ROOFLINE_LOOPS; i++) {
+        double rate;
+
+        bench_run(cfg, &roofline_loops[i], args, &stats[i]);
+
+        rate = roofline_rate(&stats[i], args->len);
+        if(rate > peak[roofline_loops[i].op])
+            peak[roofline_loops[i].op] = rate;
+    }
+
+    for(i = 0; i < ROOFLINE_LOOPS; i++)
+        roofline_print(cfg, "loop", &roofline_loops[i], regime, args, &stats[i], peak);
+
+    for(o = 0; o < sizeof(roofline_ops) / sizeof(roofline_ops[0]); o++) {
+        for(impl = bench_impls(roofline_ops[o]); impl->name; impl++) {
+            bench_run(cfg, impl, args, &stats[0]);
+            roofline_print(cfg, "kernel", impl, regime, args, &stats[0], peak);
+        }
+    }
+
+    for(impl = roofline_kernels; impl->name; impl++) {
+        bench_run(cfg, impl, args, &stats[0]);
+        roofline_print(cfg, "kernel", impl, regime, args, &stats[0], peak);
+    }
+}
+
+void bench_roofline(const bench_config *cfg, size_t out_size) {
+    bench_args args;
+    bench_extra extra = ROOFLINE_COLUMNS;
+    void *src_raw, *dst_raw;
+
+    out_size &= ~(size_t)(ROOFLINE_BLOCK - 1);
+    if(out_size < ROOFLINE_IN_SIZE)
+        out_size = ROOFLINE_IN_SIZE;
+
+    args.src = bench_alloc(out_size, &src_raw);
+    args.dst = bench_alloc(out_size + 2 * BENCH_GUARD, &dst_raw) + BENCH_GUARD;
+    args.val = 0x5a;
+
+    bench_result_header(cfg->format, &extra);
+
+    args.len = ROOFLINE_IN_SIZE;
+    roofline_regime(cfg, &args, "in");
+
+    args.len = out_size;
+    roofline_regime(cfg, &args, "out");
+
+    free(src_raw);
+    free(dst_raw);
+}
@@ -0,0 +1,175 @@
+// strlen, memchr and strchr by length and match position
+//
+// A byte search costs as much as the bytes in front of what it finds, so
+// memchr and strchr are timed over every length with the character at the
+// start, the middle and the end, and with no match at all (memchr then scans
+// the whole length, strchr stops at the terminator). strlen's only match is
+// the terminator, so it has one row per length. Each runs with the string on
+// a word boundary and 3 bytes past one, where the *_moop versions step bytes
+// up to the boundary first.
+//
+// The moop versions are checked against libc (newlib on KallistiOS) before
+// they are timed. The buffers stay warm; the -c cache state is ignored. MB_s
+// is over the bytes up to and including the match or terminator. Rows are
+// keyed by the Match position, with the string's offset as Src_Align.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+
+// What every function is called through: the string or buffer, the character
+// and the length (which only memchr uses). Returns the length or the match.
+typedef uintptr_t (*strings_fn)(const char *s, int c, size_t n);
+
+// Never in the filler text
+#define STRINGS_CHAR 'Z'
+
+static uintptr_t strings_strlen_libc(const char *s, int c, size_t n) {
+    (void)c;
+    (void)n;
+    return strlen(s);
+}
+
+static uintptr_t strings_strlen_moop(const char *s, int c, size_t n) {
+    (void)c;
+    (void)n;
+    return strlen_moop(s);
+}
+
+static uintptr_t strings_memchr_libc(const char *s, int c, size_t n) {
+    return (uintptr_t)memchr(s, c, n);
+}
+
+static uintptr_t strings_memchr_moop(const char *s, int c, size_t n) {
+    return (uintptr_t)memchr_moop(s, c, n);
+}
+
+static uintptr_t strings_strchr_libc(const char *s, int c, size_t n) {
+    (void)n;
+    return (uintptr_t)strchr(s, c);
+}
+
+static uintptr_t strings_strchr_moop(const char *s, int c, size_t n) {
+    (void)n;
+    return (uintptr_t)strchr_moop(s, c);
+}
+
+static const struct {
+    bench_op op;
+    const char *libc_name;
+    const char *moop_name;
+    strings_fn libc;
+    strings_fn moop;
+    int positions; // looks for STRINGS_CHAR, not just the terminator
+    int terminated; // stops at the terminator
+} strings_funcs[] = {
+    { BENCH_OP_STRLEN, "Strlen", "Strlen_Moop", strings_strlen_libc, strings_strlen_moop, 0, 1 },
+    { BENCH_OP_MEMCHR, "Memchr", "Memchr_Moop", strings_memchr_libc, strings_memchr_moop, 1, 0 },
+    { BENCH_OP_STRCHR, "Strchr", "Strchr_Moop", strings_strchr_libc, strings_strchr_moop, 1, 1 },
+};
+
+static const unsigned strings_aligns[] = { 0, 3 };
+
+typedef enum {
+    STRINGS_NONE,
+    STRINGS_FIRST,
+    STRINGS_MIDDLE,
+    STRINGS_LAST,
+    STRINGS_POSITIONS
+} strings_position;
+
+static const char * const strings_position_names[STRINGS_POSITIONS] = { "none", "first", "middle", "last" };
+
+// Keeps the results alive so the calls can't be dropped
+static volatile uintptr_t strings_sink;
+
+typedef struct {
+    strings_fn fn;
+    const char *s;
+    size_t len;
+} strings_call;
+
+static void strings_run(void *ctx, unsigned count) {
+    const strings_call *call = ctx;
+    uintptr_t sum = 0;
+    unsigned i;
+
+    for(i = 0; i < count; i++)
+        sum += call->fn(call->s, STRINGS_CHAR, call->len);
+
+    strings_sink = sum;
+}
+
+static void strings_row(const bench_config *cfg, bench_op op, size_t len, unsigned offset,
+    const char *match, const char *impl, strings_fn fn, const char *s, size_t scanned, double *samples) {
+    bench_align align = { offset, 0 };
+    bench_extra extra = { 1, 2, { "Match", "MB_s" } };
+    strings_call call = { fn, s, len };
+    bench_stats stats;
+
+    bench_measure(cfg, strings_run, &call, samples, &stats);
+
+    bench_extra_set(&extra, 0, "%s", match);
+    bench_extra_set(&extra, 1, "%.1f", stats.median > 0 ? (double)scanned * 1000.0 / stats.median : 0.0);
+    bench_result_print(cfg->format, cfg, op, impl, len, &align, &stats, &extra);
+}
+
+void bench_strings(const bench_config *cfg, size_t max_size) {
+    double *samples = malloc(cfg->repetitions * sizeof(double));
+    void *raw;
+    char *buf = (char *)bench_alloc(max_size + BENCH_MAX_ALIGN + 1, &raw);
+    bench_extra extra = { 1, 2, { "Match", "MB_s" } };
+    size_t len, i;
+    unsigned f, a, p;
+
+    if(!samples) {
+        fprintf(stderr, "bench: out of memory\n");
+        abort();
+    }
+
+    bench_result_header(cfg->format, &extra);
+
+    for(f = 0; f < sizeof(strings_funcs) / sizeof(strings_funcs[0]); f++) {
+        for(a = 0; a < sizeof(strings_aligns) / sizeof(strings_aligns[0]); a++) {
+            char *s = buf + strings_aligns[a];
+
+            for(len = 1; len <= max_size; len = bench_next_size(len)) {
+                for(i = 0; i < len; i++)
+                    s[i] = (char)('a' + i % 26);
+                s[len] = '\0';
+
+                for(p = 0; p < (strings_funcs[f].positions ? STRINGS_POSITIONS : 1); p++) {
+                    size_t pos = p == STRINGS_FIRST ? 0 : p == STRINGS_MIDDLE ? len / 2 : len - 1;
+                    size_t scanned = p == STRINGS_NONE ? len + strings_funcs[f].terminated : pos + 1;
+                    char saved = s[pos];
+
+                    // A single byte only has a first position
+                    if(len == 1 && p > STRINGS_FIRST)
+                        break;
+
+                    if(p != STRINGS_NONE)
+                        s[pos] = STRINGS_CHAR;
+
+                    if(strings_funcs[f].moop(s, STRINGS_CHAR, len) != strings_funcs[f].libc(s, STRINGS_CHAR, len)) {
+                        fprintf(stderr, "bench: %s at %u bytes, offset %u, match %s differs from libc\n",
+                            strings_funcs[f].moop_name, (unsigned)len, strings_aligns[a], strings_position_names[p]);
+                        abort();
+                    }
+
+                    strings_row(cfg, strings_funcs[f].op, len, strings_aligns[a], strings_position_names[p],
+                        strings_funcs[f].libc_name, strings_funcs[f].libc, s, scanned, samples);
+                    strings_row(cfg, strings_funcs[f].op, len, strings_aligns[a], strings_position_names[p],
+                        strings_funcs[f].moop_name, strings_funcs[f].moop, s, scanned, samples);
+
+                    s[pos] = saved;
+                }
+            }
+        }
+    }
+
+    free(samples);
+    free(raw);
+}
@@ -0,0 +1,92 @@
+// Selectable size sweep
+//
+// The default mode: every operation, alignment, size and implementation picked
+// on the command line (see bench_selection), in wide, long or JSON output.
+// Wide output has one block per (operation, alignment), each with its own
+// header line, separated by blank lines. Long and JSON output follow the
+// result schema in bench_results.c.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+
+static const bench_op sweep_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+void bench_sweep(const bench_config *cfg, const bench_selection *sel) {
+    const bench_impl *impl;
+    bench_args args;
+    bench_stats stats;
+    void *src_raw, *dst_raw;
+    uint8_t *src_buf, *dst_buf;
+    size_t max_size = 0;
+    unsigned o, a, i, blocks = 0;
+
+    for(i = 0; i < sel->size_count; i++) {
+        if(sel->sizes[i] > max_size)
+            max_size = sel->sizes[i];
+    }
+
+    src_buf = bench_alloc(max_size + BENCH_MAX_ALIGN, &src_raw);
+    dst_buf = bench_alloc(max_size + BENCH_MAX_ALIGN + 2 * BENCH_GUARD, &dst_raw);
+    args.val = 0x5a;
+
+    if(cfg->format != BENCH_FORMAT_WIDE)
+        bench_result_header(cfg->format, NULL);
+
+    for(o = 0; o < sizeof(sweep_ops) / sizeof(sweep_ops[0]); o++) {
+        bench_op op = sweep_ops[o];
+
+        if(!(sel->ops & (1u << op)))
+            continue;
+
+        for(a = 0; a < sel->align_count; a++) {
+            const bench_align *align = &sel->aligns[a];
+
+            args.src = src_buf + align->src;
+            args.dst = dst_buf + BENCH_GUARD + align->dst;
+
+            if(cfg->format == BENCH_FORMAT_WIDE) {
+                if(blocks++)
+                    printf("\n");
+
+                printf("Bytes");
+                for(impl = bench_impls(op); impl->name; impl++) {
+                    if(bench_impl_selected(sel, impl))
+                        bench_print_stats_header(impl->name);
+                }
+                printf("\n");
+            }
+
+            for(i = 0; i < sel->size_count; i++) {
+                args.len = sel->sizes[i];
+
+                if(cfg->format == BENCH_FORMAT_WIDE)
+                    printf("%u", (unsigned)args.len);
+
+                for(impl = bench_impls(op); impl->name; impl++) {
+                    if(!bench_impl_selected(sel, impl))
+                        continue;
+
+                    bench_run(cfg, impl, &args, &stats);
+
+                    switch(cfg->format) {
+                        case BENCH_FORMAT_WIDE:
+                            bench_print_stats(&stats);
+                            break;
+                        case BENCH_FORMAT_LONG:
+                        case BENCH_FORMAT_JSON:
+                            bench_result_print(cfg->format, cfg, op, impl->name, args.len, align, &stats, NULL);
+                            break;
+                    }
+                }
+
+                if(cfg->format == BENCH_FORMAT_WIDE)
+                    printf("\n");
+            }
+        }
+    }
+
+    free(src_raw);
+    free(dst_raw);
+}
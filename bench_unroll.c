@@ -0,0 +1,113 @@
+// Unroll sweep over the generated kernel family
+//
+// Times every width x unroll kernel from memkernels.c for copy, move and set
+// at a range of sizes, and flags the fastest median per (operation, size) in
+// the Best column. Sizes are multiples of the largest block (64 bytes), so
+// every kernel does the same work with no tail.
+//
+// memmove rows are backward moves with the destination UNROLL_OVERLAP bytes
+// above the source, the direction where the move kernels differ from memcpy.
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+
+#define UNROLL_MAX_SIZE 16384
+#define UNROLL_OVERLAP 32 // keeps 8-byte alignment for the 64-bit kernels
+
+static const size_t unroll_sizes[] = { 64, 256, 1024, 4096, 16384 };
+
+static const bench_op unroll_ops[] = { BENCH_OP_MEMCPY, BENCH_OP_MEMMOVE, BENCH_OP_MEMSET };
+
+// The benchmark passes lengths in bytes, the kernels count blocks
+#define UNROLL_WRAPPERS(w, u, bytes) \
+    static void * unroll_memcpy_##w##_##u(void *dest, const void *src, size_t n) { \
+        return memcpy_##w##bit_x##u(dest, src, n / bytes); \
+    } \
+    static void * unroll_memmove_##w##_##u(void *dest, const void *src, size_t n) { \
+        return memmove_##w##bit_x##u(dest, src, n / bytes); \
+    } \
+    static void * unroll_memset_##w##_##u(void *dest, int c, size_t n) { \
+        return memset_##w##bit_x##u(dest, (uint8_t)c * 0x01010101u, n / bytes); \
+    }
+
+MEMFUNCS_KERNEL_FAMILY(UNROLL_WRAPPERS)
+
+#define UNROLL_ENTRY(w, u, bytes) \
+    { w, u, unroll_memcpy_##w##_##u, unroll_memmove_##w##_##u, unroll_memset_##w##_##u },
+
+static const struct {
+    unsigned width;
+    unsigned unroll;
+    bench_copy_fn copy;
+    bench_copy_fn move;
+    bench_set_fn set;
+} unroll_kernels[] = {
+    MEMFUNCS_KERNEL_FAMILY(UNROLL_ENTRY)
+};
+
+#define UNROLL_KERNELS (sizeof(unroll_kernels) / sizeof(unroll_kernels[0]))
+
+static uint8_t src_buf[UNROLL_MAX_SIZE]__attribute__((aligned(32)));
+static uint8_t dst_buf[UNROLL_MAX_SIZE + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+static uint8_t move_buf[UNROLL_MAX_SIZE + UNROLL_OVERLAP + 2 * BENCH_GUARD]__attribute__((aligned(32)));
+
+void bench_unroll_sweep(const bench_config *cfg) {
+    bench_stats stats[UNROLL_KERNELS];
+    bench_args args;
+    bench_align align;
+    bench_extra extra = { 0, 3, { "Width", "Unroll", "Best" } }; // Best: 1 for the lowest median of the group
+    char names[UNROLL_KERNELS][32];
+    unsigned o, i, k;
+
+    bench_result_header(cfg->format, &extra);
+
+    args.val = 0x5a;
+
+    for(o = 0; o < sizeof(unroll_ops) / sizeof(unroll_ops[0]); o++) {
+        bench_op op = unroll_ops[o];
+
+        if(op == BENCH_OP_MEMMOVE) {
+            args.src = move_buf + BENCH_GUARD;
+            args.dst = move_buf + BENCH_GUARD + UNROLL_OVERLAP;
+        }
+        else {
+            args.src = src_buf;
+            args.dst = dst_buf + BENCH_GUARD;
+        }
+
+        align.src = (uintptr_t)args.src % BENCH_MAX_ALIGN;
+        align.dst = (uintptr_t)args.dst % BENCH_MAX_ALIGN;
+
+        for(i = 0; i < sizeof(unroll_sizes) / sizeof(unroll_sizes[0]); i++) {
+            unsigned best = 0;
+
+            args.len = unroll_sizes[i];
+
+            for(k = 0; k < UNROLL_KERNELS; k++) {
+                bench_impl impl = { names[k], op, NULL, NULL, -1 };
+
+                snprintf(names[k], sizeof(names[k]), "%s_%ubit_x%u", bench_op_name(op),
+                    unroll_kernels[k].width, unroll_kernels[k].unroll);
+
+                if(op == BENCH_OP_MEMSET)
+                    impl.set = unroll_kernels[k].set;
+                else
+                    impl.copy = op == BENCH_OP_MEMMOVE ? unroll_kernels[k].move : unroll_kernels[k].copy;
+
+                bench_run(cfg, &impl, &args, &stats[k]);
+
+                if(stats[k].median < stats[best].median)
+                    best = k;
+            }
+
+            for(k = 0; k < UNROLL_KERNELS; k++) {
+                bench_extra_set(&extra, 0, "%u", unroll_kernels[k].width);
+                bench_extra_set(&extra, 1, "%u", unroll_kernels[k].unroll);
+                bench_extra_set(&extra, 2, "%d", k == best);
+                bench_result_print(cfg->format, cfg, op, names[k], args.len, &align, &stats[k], &extra);
+            }
+        }
+    }
+}
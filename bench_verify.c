@@ -0,0 +1,385 @@
+// Kernel verification
+//
+// Runs the kernels and the *_moop front ends that dispatch to them on random
+// sizes, offsets and data, and checks every call against libc. Copies and sets
+// are compared over the whole destination buffer, so a stray write outside
+// the destination fails too.
+//
+// The SH4 inline assembly only runs on SH4, so this is the mode to run under
+// qemu-sh4 (make verify-qemu) or on the Dreamcast after touching a kernel.
+// Elsewhere it checks the C fallbacks. One line per check goes to stdout, the
+// first few failures of each to stderr, and main() exits 1 if any failed.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "memfuncs.h"
+
+#define VERIFY_SIZE_BITS 14 // sizes up to 16 KB, enough for the line kernels
+#define VERIFY_MAX_SIZE (1 << VERIFY_SIZE_BITS)
+#define VERIFY_BUF (VERIFY_MAX_SIZE + 2 * BENCH_MAX_ALIGN)
+#define VERIFY_REPORT 5 // failures printed per check
+
+static uint8_t verify_src[VERIFY_BUF]__attribute__((aligned(32)));
+static uint8_t verify_dst[VERIFY_BUF]__attribute__((aligned(32)));
+static uint8_t verify_ref[VERIFY_BUF]__attribute__((aligned(32)));
+
+static uint32_t verify_rng = 0x2545f491;
+
+static uint32_t verify_random(void) {
+    uint32_t x = verify_rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return verify_rng = x;
+}
+
+// Below 2^VERIFY_SIZE_BITS, spread evenly over the powers of two so small
+// sizes, where most of the dispatch is, get as many cases as large ones
+static size_t verify_size(void) {
+    return verify_random() & ((2u << (verify_random() % VERIFY_SIZE_BITS)) - 1);
+}
+
+static void verify_random_bytes(uint8_t *p, size_t len) {
+    size_t i;
+
+    for(i = 0; i < len; i++)
+        p[i] = (uint8_t)verify_random();
+}
+
+// Fresh random source and destination bytes over the span a call of len
+// bytes can reach, and the destination again in the reference. The rest of
+// the buffers already match from the last case.
+static void verify_fill(size_t len) {
+    size_t span = len + 2 * BENCH_MAX_ALIGN;
+
+    if(span > VERIFY_BUF)
+        span = VERIFY_BUF;
+
+    verify_random_bytes(verify_src, span);
+    verify_random_bytes(verify_dst, span);
+    memcpy(verify_ref, verify_dst, span);
+}
+
+// Counts and reports a destination buffer that differs from the reference,
+// then brings the two back in line for the next case
+static void verify_compare(const char *name, unsigned *failures, size_t len, unsigned s, unsigned d) {
+    if(!memcmp(verify_dst, verify_ref, VERIFY_BUF))
+        return;
+
+    if(++*failures <= VERIFY_REPORT)
+        fprintf(stderr, "verify: %s wrong at %u bytes, offsets %u:%u\n", name, (unsigned)len, s, d);
+    memcpy(verify_ref, verify_dst, VERIFY_BUF);
+}
+
+// Destination 4-byte aligned, source anywhere, whole words
+static unsigned verify_copy_shift(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % BENCH_MAX_ALIGN;
+        unsigned d = verify_random() % (BENCH_MAX_ALIGN / 4) * 4;
+        size_t len = verify_size() & ~(size_t)3;
+
+        verify_fill(len);
+        memcpy(verify_ref + d, verify_src + s, len);
+        memcpy_32bit_shift(verify_dst + d, verify_src + s, len / 4);
+        verify_compare("memcpy_32bit_shift", &failures, len, s, d);
+    }
+
+    return failures;
+}
+
+static unsigned verify_memcpy(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % BENCH_MAX_ALIGN;
+        unsigned d = verify_random() % BENCH_MAX_ALIGN;
+        size_t len = verify_size();
+
+        verify_fill(len);
+        memcpy(verify_ref + d, verify_src + s, len);
+        memcpy_moop(verify_dst + d, verify_src + s, len);
+        verify_compare("memcpy_moop", &failures, len, s, d);
+    }
+
+    return failures;
+}
+
+// Destination 32-byte aligned, whole lines, with the source 8-byte aligned
+// and ending at the end of its buffer, where the prefetches run out
+static unsigned verify_copy_movca(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        size_t len = verify_size() & ~(size_t)31;
+        unsigned s = (unsigned)((VERIFY_BUF - len) & ~(size_t)7);
+        unsigned d = verify_random() % 2 * 32;
+
+        verify_fill(len);
+        verify_random_bytes(verify_src + s, len);
+        memcpy(verify_ref + d, verify_src + s, len);
+        memcpy_64bit_32Bytes_movca(verify_dst + d, verify_src + s, len / 32);
+        verify_compare("memcpy_64bit_32Bytes_movca", &failures, len, s, d);
+    }
+
+    return failures;
+}
+
+// Destination 32-byte aligned, whole lines, any fill byte and zeroes
+static unsigned verify_set_movca(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        size_t len = verify_size() & ~(size_t)31;
+        unsigned d = verify_random() % 2 * 32;
+        uint8_t c = (uint8_t)verify_random();
+
+        verify_fill(len);
+        memset(verify_ref + d, c, len);
+        memset_64bit_32Bytes_movca(verify_dst + d, c * 0x01010101u, len / 32);
+        verify_compare("memset_64bit_32Bytes_movca", &failures, len, 0, d);
+
+        verify_fill(len);
+        memset(verify_ref + d, 0, len);
+        memset_zeroes_64bit_32Bytes_movca(verify_dst + d, len / 32);
+        verify_compare("memset_zeroes_64bit_32Bytes_movca", &failures, len, 0, d);
+    }
+
+    return failures;
+}
+
+// Zero half the time, since memset_moop has separate kernels for it
+static unsigned verify_memset(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned d = verify_random() % BENCH_MAX_ALIGN;
+        size_t len = verify_size();
+        uint8_t c = verify_random() & 1 ? (uint8_t)verify_random() : 0;
+
+        verify_fill(len);
+        memset(verify_ref + d, c, len);
+        memset_moop(verify_dst + d, c * 0x01010101u, len);
+        verify_compare("memset_moop", &failures, len, 0, d);
+    }
+
+    return failures;
+}
+
+// Both 8-byte aligned within the destination buffer, overlapping either way
+static unsigned verify_move_32bytes(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % 8 * 8;
+        unsigned d = verify_random() % 8 * 8;
+        size_t len = verify_size() & ~(size_t)31;
+
+        verify_fill(len);
+        memmove(verify_ref + d, verify_ref + s, len);
+        memmove_64bit_32Bytes(verify_dst + d, verify_dst + s, len / 32);
+        verify_compare("memmove_64bit_32Bytes", &failures, len, s, d);
+    }
+
+    return failures;
+}
+
+// Within the destination buffer, so most moves overlap, in either direction
+static unsigned verify_memmove(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % (2 * BENCH_MAX_ALIGN);
+        unsigned d = verify_random() % (2 * BENCH_MAX_ALIGN);
+        size_t len = verify_size();
+
+        verify_fill(len);
+        memmove(verify_ref + d, verify_ref + s, len);
+        memmove_moop(verify_dst + d, verify_dst + s, len);
+        verify_compare("memmove_moop", &failures, len, s, d);
+    }
+
+    return failures;
+}
+
+// Equal buffers of len bytes at src + s and dst + d, then, unless len is 0
+// or by chance, one byte of the second changed. Returns where, len if nowhere.
+// The reference follows dst, as verify_fill() expects.
+static size_t verify_differ(size_t len, unsigned s, unsigned d) {
+    size_t at = len ? verify_random() % (len + len / 4 + 1) : 0;
+
+    verify_fill(len);
+    memcpy(verify_dst + d, verify_src + s, len);
+    if(at < len)
+        verify_dst[d + at] ^= (uint8_t)(1 + verify_random() % 255);
+    memcpy(verify_ref + d, verify_dst + d, len);
+
+    return at < len ? at : len;
+}
+
+static int verify_sign(int x) {
+    return (x > 0) - (x < 0);
+}
+
+// 8-byte aligned, whole lines, equal up to a random block or all the way
+static unsigned verify_compare_32bytes(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % 8 * 8;
+        unsigned d = verify_random() % 8 * 8;
+        size_t len = verify_size() & ~(size_t)31;
+        size_t at = verify_differ(len, s, d);
+        size_t equal = memcmp_64bit_32Bytes_prefix(verify_src + s, verify_dst + d, len / 32);
+
+        if(equal != at / 32 && ++failures <= VERIFY_REPORT)
+            fprintf(stderr, "verify: memcmp_64bit_32Bytes_prefix wrong at %u bytes, offsets %u:%u\n",
+                (unsigned)len, s, d);
+    }
+
+    return failures;
+}
+
+// Any offsets, differing anywhere or nowhere; only the sign has to match
+static unsigned verify_memcmp(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % BENCH_MAX_ALIGN;
+        unsigned d = verify_random() % BENCH_MAX_ALIGN;
+        size_t len = verify_size();
+
+        verify_differ(len, s, d);
+        if(verify_sign(memcmp_moop(verify_src + s, verify_dst + d, len)) !=
+            verify_sign(memcmp(verify_src + s, verify_dst + d, len)) && ++failures <= VERIFY_REPORT)
+            fprintf(stderr, "verify: memcmp_moop wrong at %u bytes, offsets %u:%u\n", (unsigned)len, s, d);
+    }
+
+    return failures;
+}
+
+// A string of len random bytes at src + s, none of them 0 or c except c
+// itself at a random position (or nowhere), followed by its terminator and
+// more random bytes
+static void verify_string(size_t len, unsigned s, uint8_t c) {
+    size_t at = len ? verify_random() % (len + len / 4 + 1) : 0, i;
+
+    verify_random_bytes(verify_src + s, len + BENCH_MAX_ALIGN);
+    for(i = 0; i < len; i++) {
+        while(!verify_src[s + i] || verify_src[s + i] == c)
+            verify_src[s + i] = (uint8_t)verify_random();
+    }
+    verify_src[s + len] = 0;
+
+    if(at < len)
+        verify_src[s + at] = c;
+}
+
+// strlen_moop, memchr_moop and strchr_moop on the same strings, which start
+// anywhere, have the byte looked for anywhere or nowhere, and sometimes look
+// for the terminator itself
+static unsigned verify_scan(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned s = verify_random() % BENCH_MAX_ALIGN;
+        size_t len = verify_size();
+        uint8_t c = verify_random() % 8 ? (uint8_t)(1 + verify_random() % 255) : 0;
+        const char *str = (const char *)verify_src + s;
+        int wrong = 0;
+
+        verify_string(len, s, c);
+        wrong |= strlen_moop(str) != strlen(str);
+        wrong |= memchr_moop(str, c, len) != memchr(str, c, len);
+        wrong |= strchr_moop(str, c) != strchr(str, c);
+
+        if(wrong && ++failures <= VERIFY_REPORT)
+            fprintf(stderr, "verify: strlen/memchr/strchr_moop wrong at %u bytes, offset %u, byte %u\n",
+                (unsigned)len, s, c);
+    }
+
+    return failures;
+}
+
+#define VERIFY_KERNEL_ENTRY(w, u, bytes) \
+    { "memcpy_" #w "bit_x" #u, "memmove_" #w "bit_x" #u, "memset_" #w "bit_x" #u, w / 8, bytes, \
+        memcpy_##w##bit_x##u, memmove_##w##bit_x##u, memset_##w##bit_x##u },
+
+static const struct {
+    const char *copy_name;
+    const char *move_name;
+    const char *set_name;
+    unsigned align;
+    unsigned block;
+    void * (*copy)(void *dest, const void *src, size_t len);
+    void * (*move)(void *dest, const void *src, size_t len);
+    void * (*set)(void *dest, const uint32_t val, size_t len);
+} verify_kernels[] = {
+    MEMFUNCS_KERNEL_FAMILY(VERIFY_KERNEL_ENTRY)
+};
+
+// A random memkernels.c kernel per case: a copy, a move within the
+// destination buffer either way, and a set, all at the kernel's alignment
+static unsigned verify_family(unsigned cases) {
+    unsigned i, failures = 0;
+
+    for(i = 0; i < cases; i++) {
+        unsigned k = verify_random() % (sizeof(verify_kernels) / sizeof(verify_kernels[0]));
+        unsigned align = verify_kernels[k].align, block = verify_kernels[k].block;
+        unsigned s = verify_random() % (2 * BENCH_MAX_ALIGN / align) * align;
+        unsigned d = verify_random() % (2 * BENCH_MAX_ALIGN / align) * align;
+        size_t len = verify_size() / block * block;
+        uint8_t c = (uint8_t)verify_random();
+
+        verify_fill(len);
+        memcpy(verify_ref + d, verify_src + s, len);
+        verify_kernels[k].copy(verify_dst + d, verify_src + s, len / block);
+        verify_compare(verify_kernels[k].copy_name, &failures, len, s, d);
+
+        verify_fill(len);
+        memmove(verify_ref + d, verify_ref + s, len);
+        verify_kernels[k].move(verify_dst + d, verify_dst + s, len / block);
+        verify_compare(verify_kernels[k].move_name, &failures, len, s, d);
+
+        verify_fill(len);
+        memset(verify_ref + d, c, len);
+        verify_kernels[k].set(verify_dst + d, c * 0x01010101u, len / block);
+        verify_compare(verify_kernels[k].set_name, &failures, len, 0, d);
+    }
+
+    return failures;
+}
+
+static const struct {
+    const char *name;
+    unsigned (*run)(unsigned cases);
+} verify_checks[] = {
+    { "memcpy_32bit_shift", verify_copy_shift },
+    { "memcpy_64bit_32Bytes_movca", verify_copy_movca },
+    { "memcpy_moop", verify_memcpy },
+    { "memmove_64bit_32Bytes", verify_move_32bytes },
+    { "memmove_moop", verify_memmove },
+    { "memset_64bit_32Bytes_movca", verify_set_movca },
+    { "memset_moop", verify_memset },
+    { "memkernels", verify_family },
+    { "memcmp_64bit_32Bytes_prefix", verify_compare_32bytes },
+    { "memcmp_moop", verify_memcmp },
+    { "strlen/memchr/strchr_moop", verify_scan },
+};
+
+unsigned bench_verify(unsigned cases) {
+    unsigned c, failures = 0;
+
+    for(c = 0; c < sizeof(verify_checks) / sizeof(verify_checks[0]); c++) {
+        unsigned f = verify_checks[c].run(cases);
+
+        printf("%s: %u cases, %u failed\n", verify_checks[c].name, cases, f);
+        failures += f;
+    }
+
+    return failures;
+}
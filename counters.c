@@ -0,0 +1,50 @@
+// Counter backend registry
+
+#include <stdio.h>
+#include <string.h>
+
+#include "counters.h"
+
+static const counter_backend * const backends[] = {
+    &counter_backend_sh4,
+    &counter_backend_perf,
+};
+
+const counter_backend * counters_select(const char *name, unsigned *events) {
+    unsigned i;
+    int any = !strcmp(name, "auto");
+
+    for(i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if(!any && strcmp(name, backends[i]->name))
+            continue;
+
+        *events = backends[i]->init();
+        if(*events)
+            return backends[i];
+
+        if(!any) {
+            fprintf(stderr, "counters: %s is not available here\n", name);
+            return NULL;
+        }
+    }
+
+    fprintf(stderr, any ? "counters: no counter backend available here\n" : "counters: unknown backend %s\n", name);
+    return NULL;
+}
+
+const char * counter_event_name(counter_event event) {
+    switch(event) {
+        case COUNTER_CYCLES:
+            return "Cycles";
+        case COUNTER_INSTRUCTIONS:
+            return "Instructions";
+        case COUNTER_CACHE_MISSES:
+            return "Misses";
+        case COUNTER_BRANCHES:
+            return "Branches";
+        case COUNTER_EVENTS:
+            break;
+    }
+
+    return "?";
+}
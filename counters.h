@@ -0,0 +1,58 @@
+//==============================================================================
+//  Hardware Event Counters
+//==============================================================================
+//
+// A small pluggable interface over whatever performance counters the target
+// has, so the benchmark can say why a kernel is slow and not just that it is.
+// There is one backend per counter facility:
+//
+//   counters_perf.c - Linux perf_event_open (hosted builds)
+//   counters_sh4.c  - SH7750 on-chip PMCR counters (KallistiOS)
+//
+// Every backend is always linked. Those that don't apply to the build report
+// themselves as unavailable from init().
+//
+
+#ifndef __COUNTERS_H_
+#define __COUNTERS_H_
+
+#include <stdint.h>
+
+typedef enum {
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES, // L1D read misses (perf), operand cache misses (SH4)
+    COUNTER_BRANCHES, // mispredicted branches (perf), taken branches (SH4, which has no predictor)
+    COUNTER_EVENTS
+} counter_event;
+
+typedef struct {
+    const char *name; // as given to counters_select(), e.g. "perf"
+
+    // Set the counters up. Returns the bitmask of (1 << counter_event) events
+    // this backend can count here, 0 if it can't run at all.
+    unsigned (*init)(void);
+
+    // Hardware with fewer counters than events measures them over several
+    // passes of the same workload.
+    unsigned passes;
+
+    // Zero and start the counters of one pass
+    void (*start)(unsigned pass);
+
+    // Stop them and store the counts of that pass's events in values
+    void (*stop)(unsigned pass, uint64_t values[COUNTER_EVENTS]);
+} counter_backend;
+
+extern const counter_backend counter_backend_perf;
+extern const counter_backend counter_backend_sh4;
+
+// Backend by name, or with "auto" the first one that initialises. Sets
+// *events to what it can count. NULL (with a message on stderr) when there
+// is no such backend or it can't run here.
+const counter_backend * counters_select(const char *name, unsigned *events);
+
+// Column label of an event, e.g. "Misses"
+const char * counter_event_name(counter_event event);
+
+#endif /* __COUNTERS_H_ */
@@ -0,0 +1,105 @@
+// Linux perf_event_open counter backend
+//
+// One counter per event, user space only, so it works with the default
+// perf_event_paranoid setting of 2. Events the kernel or CPU can't count
+// (common in VMs and containers) are simply left out.
+
+#define _GNU_SOURCE
+
+#include "counters.h"
+
+#if defined(__linux__) && !defined(_arch_dreamcast)
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static int fds[COUNTER_EVENTS] = { -1, -1, -1, -1 };
+
+static int open_event(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static unsigned perf_init(void) {
+    unsigned events = 0;
+    unsigned e;
+
+    if(fds[COUNTER_CYCLES] < 0)
+        fds[COUNTER_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if(fds[COUNTER_INSTRUCTIONS] < 0)
+        fds[COUNTER_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    if(fds[COUNTER_CACHE_MISSES] < 0)
+        fds[COUNTER_CACHE_MISSES] = open_event(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    if(fds[COUNTER_BRANCHES] < 0)
+        fds[COUNTER_BRANCHES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        if(fds[e] >= 0)
+            events |= 1u << e;
+    }
+
+    return events;
+}
+
+static void perf_start(unsigned pass) {
+    unsigned e;
+
+    (void)pass;
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        if(fds[e] >= 0) {
+            ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+static void perf_stop(unsigned pass, uint64_t values[COUNTER_EVENTS]) {
+    unsigned e;
+
+    (void)pass;
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        if(fds[e] >= 0)
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for(e = 0; e < COUNTER_EVENTS; e++) {
+        uint64_t count = 0;
+
+        if(fds[e] >= 0 && read(fds[e], &count, sizeof(count)) == (ssize_t)sizeof(count))
+            values[e] = count;
+    }
+}
+
+#else
+
+static unsigned perf_init(void) {
+    return 0;
+}
+
+static void perf_start(unsigned pass) {
+    (void)pass;
+}
+
+static void perf_stop(unsigned pass, uint64_t values[COUNTER_EVENTS]) {
+    (void)pass;
+    (void)values;
+}
+
+#endif
+
+const counter_backend counter_backend_perf = { "perf", perf_init, 1, perf_start, perf_stop };
@@ -0,0 +1,81 @@
+// SH7750 on-chip performance counter backend (KallistiOS)
+//
+// The SH4 has two 48-bit counters, each counting one event selected in its
+// PMCR register, so the four events take two passes. The registers live in
+// P4 control space, which SH4 Linux doesn't map for user space, so this
+// backend is only available on the Dreamcast build.
+//
+// Register layout and event numbers as used by KallistiOS perf_monitor.c.
+
+#include "counters.h"
+
+#ifdef _arch_dreamcast
+
+#define PMCR(n) (*(volatile uint16_t *)(0xff000084 + ((n) << 2)))
+#define PMCTR_HIGH(n) (*(volatile uint32_t *)(0xff100004 + ((n) << 3)))
+#define PMCTR_LOW(n) (*(volatile uint32_t *)(0xff100008 + ((n) << 3)))
+
+#define PMCR_CLR 0x2000 // zero the counter
+#define PMCR_RUN 0xc000 // enable + start
+#define PMCR_PMM_MASK 0x003f
+
+// Event numbers (PMCR.PMM), counted in CPU cycles
+#define PMM_OPERAND_CACHE_MISS 0x0f
+#define PMM_BRANCH_TAKEN 0x11
+#define PMM_INSTRUCTION_ISSUED 0x13
+#define PMM_ELAPSED_TIME 0x23
+
+// Events of each pass, counter 0 then counter 1
+static const struct {
+    uint16_t mode[2];
+    counter_event event[2];
+} sh4_passes[] = {
+    { { PMM_ELAPSED_TIME, PMM_OPERAND_CACHE_MISS }, { COUNTER_CYCLES, COUNTER_CACHE_MISSES } },
+    { { PMM_INSTRUCTION_ISSUED, PMM_BRANCH_TAKEN }, { COUNTER_INSTRUCTIONS, COUNTER_BRANCHES } },
+};
+
+static unsigned sh4_init(void) {
+    return (1u << COUNTER_EVENTS) - 1;
+}
+
+static void sh4_start(unsigned pass) {
+    unsigned n;
+
+    for(n = 0; n < 2; n++) {
+        PMCR(n) = PMCR_CLR;
+        PMCR(n) = PMCR_RUN | sh4_passes[pass].mode[n];
+    }
+}
+
+static void sh4_stop(unsigned pass, uint64_t values[COUNTER_EVENTS]) {
+    unsigned n;
+
+    for(n = 0; n < 2; n++)
+        PMCR(n) &= ~(PMCR_PMM_MASK | PMCR_RUN);
+
+    for(n = 0; n < 2; n++)
+        values[sh4_passes[pass].event[n]] = ((uint64_t)(PMCTR_HIGH(n) & 0xffff) << 32) | PMCTR_LOW(n);
+}
+
+#define SH4_PASSES (sizeof(sh4_passes) / sizeof(sh4_passes[0]))
+
+#else
+
+static unsigned sh4_init(void) {
+    return 0;
+}
+
+static void sh4_start(unsigned pass) {
+    (void)pass;
+}
+
+static void sh4_stop(unsigned pass, uint64_t values[COUNTER_EVENTS]) {
+    (void)pass;
+    (void)values;
+}
+
+#define SH4_PASSES 1
+
+#endif
+
+const counter_backend counter_backend_sh4 = { "sh4", sh4_init, SH4_PASSES, sh4_start, sh4_stop };
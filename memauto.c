@@ -0,0 +1,53 @@
+#include "memauto.h"
+#include "memauto_table.h"
+#include "memfuncs.h"
+
+#include <string.h>
+
+#ifdef MEMAUTO_HAVE_FASTMEM
+#include "fastmem.h"
+#endif
+
+static const uint8_t memcpy_choice[MEMAUTO_BUCKETS] = MEMAUTO_MEMCPY_TABLE;
+static const uint8_t memmove_choice[MEMAUTO_BUCKETS] = MEMAUTO_MEMMOVE_TABLE;
+static const uint8_t memset_choice[MEMAUTO_BUCKETS] = MEMAUTO_MEMSET_TABLE;
+
+void * memcpy_auto(void *dest, const void *src, size_t numbytes) {
+    switch(memcpy_choice[memauto_bucket(numbytes)]) {
+        case MEMAUTO_MOOP:
+            return memcpy_moop(dest, src, numbytes);
+#ifdef MEMAUTO_HAVE_FASTMEM
+        case MEMAUTO_FAST:
+            return memcpy_fast(dest, src, numbytes);
+#endif
+        default:
+            return memcpy(dest, src, numbytes);
+    }
+}
+
+void * memmove_auto(void *dest, const void *src, size_t numbytes) {
+    switch(memmove_choice[memauto_bucket(numbytes)]) {
+        case MEMAUTO_MOOP:
+            return memmove_moop(dest, src, numbytes);
+#ifdef MEMAUTO_HAVE_FASTMEM
+        case MEMAUTO_FAST:
+            return memmove_fast(dest, src, numbytes);
+#endif
+        default:
+            return memmove(dest, src, numbytes);
+    }
+}
+
+void * memset_auto(void *dest, int c, size_t numbytes) {
+    switch(memset_choice[memauto_bucket(numbytes)]) {
+        case MEMAUTO_MOOP:
+            // memset_moop takes the fill pattern as a full 32-bit word
+            return memset_moop(dest, (uint8_t)c * 0x01010101u, numbytes);
+#ifdef MEMAUTO_HAVE_FASTMEM
+        case MEMAUTO_FAST:
+            return memset_fast(dest, c, numbytes);
+#endif
+        default:
+            return memset(dest, c, numbytes);
+    }
+}
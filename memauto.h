@@ -0,0 +1,46 @@
+//==============================================================================
+//  Size-Dispatched Memory Functions
+//==============================================================================
+//
+// memcpy_auto, memmove_auto and memset_auto pick libc, the *_moop functions or
+// libfastmem per call from a table indexed by log2 of the size. The table lives
+// in memauto_table.h, which "membench calibrate" regenerates from crossover
+// points measured on the machine it runs on.
+//
+// libfastmem only exists for KallistiOS. Elsewhere, table entries that pick it
+// fall back to libc.
+//
+
+#ifndef __MEMAUTO_H_
+#define __MEMAUTO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Implementation ids used in memauto_table.h
+#define MEMAUTO_LIBC 0
+#define MEMAUTO_MOOP 1
+#define MEMAUTO_FAST 2
+
+// libfastmem only exists for KallistiOS, so memcpy_fast and friends can only
+// be dispatched to and benchmarked on the Dreamcast build.
+#ifdef _arch_dreamcast
+#define MEMAUTO_HAVE_FASTMEM 1
+#endif
+
+// Bucket 0 is size 0, bucket k covers [2^(k-1), 2^k) and the last bucket
+// also takes everything larger
+#define MEMAUTO_BUCKETS 24
+
+static inline unsigned memauto_bucket(size_t numbytes) {
+    if(numbytes >= ((size_t)1 << (MEMAUTO_BUCKETS - 2)))
+        return MEMAUTO_BUCKETS - 1;
+
+    return numbytes ? 32 - __builtin_clz((uint32_t)numbytes) : 0;
+}
+
+void * memcpy_auto(void *dest, const void *src, size_t numbytes);
+void * memmove_auto(void *dest, const void *src, size_t numbytes);
+void * memset_auto(void *dest, int c, size_t numbytes);
+
+#endif /* __MEMAUTO_H_ */
@@ -0,0 +1,93 @@
+// Default table, derived from the Dreamcast memcpy numbers in membench.csv
+// (memcpy_moop up to 127 bytes, memcpy_fast above). There is no equivalent
+// data for memmove and memset yet, so they use the moop functions throughout.
+// Regenerate with "membench calibrate" on the target machine.
+//
+// One entry per memauto_bucket(): entry 0 is size 0, entry k covers
+// [2^(k-1), 2^k) bytes and the last entry everything larger.
+
+#ifndef __MEMAUTO_TABLE_H_
+#define __MEMAUTO_TABLE_H_
+
+#define MEMAUTO_MEMCPY_TABLE { \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+    MEMAUTO_FAST, \
+}
+
+#define MEMAUTO_MEMMOVE_TABLE { \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+}
+
+#define MEMAUTO_MEMSET_TABLE { \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+    MEMAUTO_MOOP, \
+}
+
+#endif /* __MEMAUTO_TABLE_H_ */
@@ -0,0 +1,279 @@
+// Public Domain
+// Compile with GCC -O3 for best performance
+
+#include "memfuncs.h"
+
+//
+// The word kernels don't return a memcmp result. They run the equal prefix as
+// fast as they can and return how many whole words (or blocks) matched;
+// memcmp_moop then looks at the bytes of the first word that didn't, so
+// finding the differing byte is only paid for on a mismatch.
+//
+
+// Compare 1 byte at a time
+// Returns the difference of the first differing bytes as unsigned chars, or 0
+int memcmp_8bit(const void *str1, const void *str2, size_t len) {
+    if(!len)
+        return 0;
+
+    const uint8_t *a = (const uint8_t *)str1;
+    const uint8_t *b = (const uint8_t *)str2;
+
+#ifdef MEMFUNCS_SH4_ASM
+    int32_t ca;
+    int32_t cb;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.b @%[a]+, %[ca]\n\t" // ca = *(a++), sign-extended (LS)
+        "mov.b @%[b]+, %[cb]\n\t" // cb = *(b++), sign-extended (LS)
+        "cmp/eq %[ca], %[cb]\n\t" // (ca == cb) ? 1 -> T : 0 -> T (MT)
+        "bf 1f\n\t" // Mismatch, len is left at least 1 (BR)
+        "dt %[size]\n\t" // (--len) ? 0 -> T : 1 -> T (EX)
+        "bf 0b\n" // (BR)
+        "1:\n"
+        : [a] "+&r" ((uint32_t)a), [b] "+&r" ((uint32_t)b), [size] "+&r" (len),
+        [ca] "=&r" (ca), [cb] "=&r" (cb) // outputs
+        : // inputs
+        : "t", "memory" // clobbers
+    );
+
+    return len ? (int)(uint8_t)ca - (int)(uint8_t)cb : 0;
+#else
+    do {
+        if(*a != *b)
+            return (int)*a - (int)*b;
+        a++;
+        b++;
+    } while(--len);
+
+    return 0;
+#endif
+}
+
+// Compare 4 bytes at a time
+// Len is (# of total bytes/4), so it's "# of 32-bits"
+// Returns the number of leading 32-bit words that are equal, len if all are
+// Both buffers must be 4-byte aligned
+size_t memcmp_32bit_prefix(const void *str1, const void *str2, size_t len) {
+    if(!len)
+        return 0;
+
+    const uint32_t *a = (const uint32_t *)str1;
+    const uint32_t *b = (const uint32_t *)str2;
+    size_t left = len;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t wa;
+    uint32_t wb;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.l @%[a]+, %[wa]\n\t" // wa = *(a++) (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // wb = *(b++) (LS)
+        "cmp/eq %[wa], %[wb]\n\t" // (wa == wb) ? 1 -> T : 0 -> T (MT)
+        "bf 1f\n\t" // Mismatch, left counts it and the words after it (BR)
+        "dt %[size]\n\t" // (--left) ? 0 -> T : 1 -> T (EX)
+        "bf 0b\n" // (BR)
+        "1:\n"
+        : [a] "+&r" ((uint32_t)a), [b] "+&r" ((uint32_t)b), [size] "+&r" (left),
+        [wa] "=&r" (wa), [wb] "=&r" (wb) // outputs
+        : // inputs
+        : "t", "memory" // clobbers
+    );
+#else
+    while(left && *a == *b) {
+        a++;
+        b++;
+        left--;
+    }
+#endif
+
+    return len - left;
+}
+
+// Compare 32 bytes at a time, i.e. a cache line per iteration
+// Len is (# of total bytes/32), so it's "# of 32 Bytes"
+// Returns the number of leading 32-byte blocks that are equal, len if all are
+// Both buffers must be 8-byte aligned
+//
+// SH4 has no 64-bit integer loads (fmov.d goes to the FPU, whose compares
+// treat NaNs and -0.0 as numbers, not bit patterns), so there each 64-bit word
+// is a pair of 32-bit loads. The differences of the whole line are ORed
+// together and tested once, one branch per 32 bytes.
+size_t memcmp_64bit_32Bytes_prefix(const void *str1, const void *str2, size_t len) {
+    if(!len)
+        return 0;
+
+    size_t left = len;
+
+#ifdef MEMFUNCS_SH4_ASM
+    const uint32_t *a = (const uint32_t *)str1;
+    const uint32_t *b = (const uint32_t *)str2;
+
+    uint32_t diff;
+    uint32_t wa;
+    uint32_t wb;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.l @%[a]+, %[diff]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wb], %[diff]\n\t" // diff = a[0] ^ b[0] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[1] ^ b[1] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[2] ^ b[2] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[3] ^ b[3] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[4] ^ b[4] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[5] ^ b[5] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[6] ^ b[6] (EX)
+        "mov.l @%[a]+, %[wa]\n\t" // (LS)
+        "mov.l @%[b]+, %[wb]\n\t" // (LS)
+        "xor %[wa], %[wb]\n\t" // (EX)
+        "or %[wb], %[diff]\n\t" // diff |= a[7] ^ b[7] (EX)
+        "tst %[diff], %[diff]\n\t" // (diff == 0) ? 1 -> T : 0 -> T (MT)
+        "bf 1f\n\t" // Mismatch, left counts this block and the ones after it (BR)
+        "dt %[size]\n\t" // (--left) ? 0 -> T : 1 -> T (EX)
+        "bf 0b\n" // (BR)
+        "1:\n"
+        : [a] "+&r" ((uint32_t)a), [b] "+&r" ((uint32_t)b), [size] "+&r" (left),
+        [diff] "=&r" (diff), [wa] "=&r" (wa), [wb] "=&r" (wb) // outputs
+        : // inputs
+        : "t", "memory" // clobbers
+    );
+#else
+    const uint64_t *a = (const uint64_t *)str1;
+    const uint64_t *b = (const uint64_t *)str2;
+
+    do {
+        uint64_t diff = (a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3]);
+
+        if(diff)
+            break;
+
+        a += 4;
+        b += 4;
+    } while(--left);
+#endif
+
+    return len - left;
+}
+
+// Compare 4 bytes at a time with the buffers misaligned to each other
+// Len is (# of total bytes/4), so it's "# of 32-bits"
+// Returns the number of leading 32-bit words of str1 that are equal, len if all are
+// str1 must be 4-byte aligned, str2 can be anywhere
+//
+// Like memcpy_32bit_shift, str2 is read as aligned words and each comparison
+// word is merged from two of them, so nothing outside the aligned words that
+// hold str2's bytes is read. Plain C on every target; memcmp_moop only takes
+// it for compares long enough that the merge beats a byte loop.
+size_t memcmp_32bit_shift_prefix(const void *str1, const void *str2, size_t len) {
+    if(!len)
+        return 0;
+
+    uint32_t shift = ((uintptr_t)str2 & 0x03) << 3; // bits to drop from each word
+
+    if(!shift)
+        return memcmp_32bit_prefix(str1, str2, len);
+
+    const uint32_t *a = (const uint32_t *)str1;
+    const uint32_t *b = (const uint32_t *)((uintptr_t)str2 & ~(uintptr_t)0x03);
+    uint32_t cur = *b++;
+    size_t left = len;
+
+    do {
+        uint32_t next = *b++;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        uint32_t word = (cur << shift) | (next >> (32 - shift));
+#else
+        uint32_t word = (cur >> shift) | (next << (32 - shift));
+#endif
+
+        if(*a++ != word)
+            break;
+
+        cur = next;
+    } while(--left);
+
+    return len - left;
+}
+
+//
+// Memcmp moop
+//
+
+// Below this, peeling to alignment costs more than the word loops save
+#define MOOP_PEEL_MIN 16
+
+int memcmp_moop(const void *str1, const void *str2, size_t numbytes) {
+    if(str1 == str2 || numbytes == 0)
+        return 0;
+
+    const uint8_t *a = (const uint8_t *)str1;
+    const uint8_t *b = (const uint8_t *)str2;
+    uintptr_t xored = ((uintptr_t)a ^ (uintptr_t)b);
+    size_t matched;
+
+    if(numbytes >= MOOP_PEEL_MIN) {
+        // Compare head bytes until str1 is on a boundary: 8 bytes if str2 can
+        // land on one too, 4 otherwise
+        uint32_t offset = -(uintptr_t)a & ((xored & 0x07) ? 0x03 : 0x07);
+
+        if(offset) {
+            int diff = memcmp_8bit(a, b, offset);
+
+            if(diff)
+                return diff;
+
+            a += offset;
+            b += offset;
+            numbytes -= offset;
+        }
+
+        // Whole 32-byte blocks. On a mismatch the word pass below finds the
+        // word within the block.
+        if(!(xored & 0x07) && numbytes >= 32) {
+            matched = memcmp_64bit_32Bytes_prefix(a, b, numbytes >> 5) << 5;
+            a += matched;
+            b += matched;
+            numbytes -= matched;
+        }
+
+        if(!(xored & 0x03))
+            matched = memcmp_32bit_prefix(a, b, numbytes >> 2) << 2;
+        else
+            matched = memcmp_32bit_shift_prefix(a, b, numbytes >> 2) << 2;
+
+        a += matched;
+        b += matched;
+        numbytes -= matched;
+    }
+
+    // The tail, or the word that differs: the first differing byte is at
+    // most 3 bytes in
+    return memcmp_8bit(a, b, numbytes);
+}
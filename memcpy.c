@@ -21,6 +21,7 @@ void * memcpy_8bit(void *dest, const void *src, size_t len) {
     const uint8_t *s = (uint8_t *)src;
     uint8_t *d = (uint8_t *)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
     // Underflow would be like adding a negative offset
 
@@ -37,6 +38,11 @@ void * memcpy_8bit(void *dest, const void *src, size_t len) {
         : [offset] "z" (diff) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *d++ = *s++;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -51,6 +57,7 @@ void * memcpy_16bit(void *dest, const void *src, size_t len) {
     const uint16_t* s = (uint16_t*)src;
     uint16_t* d = (uint16_t*)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
     // Underflow would be like adding a negative offset
 
@@ -67,6 +74,11 @@ void * memcpy_16bit(void *dest, const void *src, size_t len) {
         : [offset] "z" (diff) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *d++ = *s++;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -81,6 +93,7 @@ void * memcpy_32bit(void *dest, const void *src, size_t len) {
     const uint32_t* s = (uint32_t*)src;
     uint32_t* d = (uint32_t*)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
     // Underflow would be like adding a negative offset
 
@@ -97,6 +110,11 @@ void * memcpy_32bit(void *dest, const void *src, size_t len) {
         : [offset] "z" (diff) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *d++ = *s++;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -110,6 +128,7 @@ void * memcpy_32bit_16Bytes(void *dest, const void *src, size_t len) {
 
     void * ret_dest = dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     uint32_t scratch_reg;
     uint32_t scratch_reg2;
     uint32_t scratch_reg3;
@@ -137,6 +156,23 @@ void * memcpy_32bit_16Bytes(void *dest, const void *src, size_t len) {
         : // inputs
         : "t", "memory" // clobbers
     );
+#else
+    const uint32_t *s = (const uint32_t *)src;
+    uint32_t *d = (uint32_t *)dest;
+
+    do {
+        uint32_t scratch = s[0];
+        uint32_t scratch2 = s[1];
+        uint32_t scratch3 = s[2];
+        uint32_t scratch4 = s[3];
+        d[0] = scratch;
+        d[1] = scratch2;
+        d[2] = scratch3;
+        d[3] = scratch4;
+        s += 4;
+        d += 4;
+    } while(--len);
+#endif
 
     return ret_dest;
 }
@@ -148,6 +184,7 @@ void * memcpy_64bit(void *dest, const void *src, size_t len) {
     if(!len)
         return dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     const _Complex float* s = (_Complex float*)src;
     _Complex float* d = (_Complex float*)dest;
 
@@ -156,6 +193,7 @@ void * memcpy_64bit(void *dest, const void *src, size_t len) {
     uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
     // Underflow would be like adding a negative offset
 
+    uint32_t fpscr = memfuncs_fpu_single();
     __asm__ volatile (
         "fschg\n\t"
         "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
@@ -170,6 +208,15 @@ void * memcpy_64bit(void *dest, const void *src, size_t len) {
         : [offset] "z" (diff) // inputs
         : "t", "memory" // clobbers
     );
+    memfuncs_fpu_restore(fpscr);
+#else
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t *d = (uint64_t *)dest;
+
+    do {
+        *d++ = *s++;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -183,11 +230,13 @@ void * memcpy_64bit_32Bytes(void *dest, const void *src, size_t len) {
 
     void * ret_dest = dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     _Complex float double_scratch;
     _Complex float double_scratch2;
     _Complex float double_scratch3;
     _Complex float double_scratch4;
 
+    uint32_t fpscr = memfuncs_fpu_single();
     __asm__ volatile (
         "fschg\n\t" // Switch to pair move mode (FE)
         "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
@@ -212,10 +261,220 @@ void * memcpy_64bit_32Bytes(void *dest, const void *src, size_t len) {
         : // inputs
         : "t", "memory" // clobbers
     );
+    memfuncs_fpu_restore(fpscr);
+#else
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t *d = (uint64_t *)dest;
+
+    do {
+        uint64_t scratch = s[0];
+        uint64_t scratch2 = s[1];
+        uint64_t scratch3 = s[2];
+        uint64_t scratch4 = s[3];
+        d[0] = scratch;
+        d[1] = scratch2;
+        d[2] = scratch3;
+        d[3] = scratch4;
+        s += 4;
+        d += 4;
+    } while(--len);
+#endif
 
     return ret_dest;
 }
 
+// lines movca.l line copies for memcpy_64bit_32Bytes_movca, prefetching at
+// prefetch and 32 bytes further on for each line. lines must be at least 1.
+// The caller switches the FPU to single precision around it.
+static inline void memcpy_movca_lines(void *dest, const void *src,
+    const char *prefetch, size_t lines) {
+#ifdef MEMFUNCS_SH4_ASM
+    _Complex float double_scratch;
+    _Complex float double_scratch2;
+    _Complex float double_scratch3;
+    _Complex float double_scratch4;
+
+    __asm__ volatile (
+        "fschg\n\t" // Switch to pair move mode (FE)
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "1:\n\t"
+        // *dest++ = *src++
+        "pref @%[pf]\n\t" // Start fetching a source line further ahead (LS)
+        "fmov.d @%[in]+, %[scratch]\n\t" // (LS)
+        "movca.l %[claim], @%[out]\n\t" // Allocate the destination line without reading it (LS)
+        "fmov.d @%[in]+, %[scratch2]\n\t" // (LS)
+        "add #32, %[pf]\n\t" // (EX)
+        "fmov.d @%[in]+, %[scratch3]\n\t" // (LS)
+        "add #32, %[out]\n\t" // (EX)
+        "fmov.d @%[in]+, %[scratch4]\n\t" // (LS)
+        "dt %[size]\n\t" // while(--lines) (EX)
+        "fmov.d %[scratch4], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch3], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch2], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch], @-%[out]\n\t" // (LS)
+        "bf.s 1b\n\t" // (BR)
+        " add #32, %[out]\n\t" // (EX)
+        "fschg\n" // Switch back to single move mode (FE)
+        : [in] "+&r" ((uint32_t)src), [out] "+&r" ((uint32_t)dest), [pf] "+&r" ((uint32_t)prefetch), [size] "+&r" (lines),
+        [scratch] "=&d" (double_scratch), [scratch2] "=&d" (double_scratch2), [scratch3] "=&d" (double_scratch3), [scratch4] "=&d" (double_scratch4) // outputs
+        : [claim] "z" (0) // inputs
+        : "t", "memory" // clobbers
+    );
+#else
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t *d = (uint64_t *)dest;
+
+    do {
+        __builtin_prefetch(prefetch);
+        uint64_t scratch = s[0];
+        uint64_t scratch2 = s[1];
+        uint64_t scratch3 = s[2];
+        uint64_t scratch4 = s[3];
+        d[0] = scratch;
+        d[1] = scratch2;
+        d[2] = scratch3;
+        d[3] = scratch4;
+        s += 4;
+        d += 4;
+        prefetch += 32;
+    } while(--lines);
+#endif
+}
+
+// 32 Bytes (one cache line) at a time, for large copies
+// Len is (# of total bytes/32), so it's "# of 32 Bytes"
+// Destination must be 32-byte aligned, source must be 8-byte aligned
+// Prefetches the source MEMFUNCS_PREF_DISTANCE bytes ahead and claims each
+// destination line with movca.l, so it is never read in from RAM just to be
+// overwritten. movca.l stores r0 to the start of the line, but all 32 bytes
+// are written right after, so that value never survives. The last lines
+// would prefetch past the end of the source, so they prefetch the line being
+// copied instead, which is already on its way.
+void * memcpy_64bit_32Bytes_movca(void *dest, const void *src, size_t len) {
+    size_t ahead = (MEMFUNCS_PREF_DISTANCE + 31) / 32;
+    size_t body = len > ahead ? len - ahead : 0;
+    char *d = (char *)dest + body * 32;
+    const char *s = (const char *)src + body * 32;
+
+    if(!len)
+        return dest;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t fpscr = memfuncs_fpu_single();
+#endif
+
+    if(body)
+        memcpy_movca_lines(dest, src, (const char *)src + MEMFUNCS_PREF_DISTANCE, body);
+    if(len > body)
+        memcpy_movca_lines(d, s, s, len - body);
+
+#ifdef MEMFUNCS_SH4_ASM
+    memfuncs_fpu_restore(fpscr);
+#endif
+
+    return dest;
+}
+
+// 4 bytes at a time from a misaligned source
+// Len is (# of total bytes/4), so it's "# of 32-bits"
+// Destination must be 4-byte aligned, source can have any alignment
+// Every load is an aligned 32-bit read: each output word is merged from two
+// adjacent source words. The first and last loaded words can include up to 3
+// bytes outside the source range, but never cross a 4-byte boundary.
+// Assumes little-endian, as on the Dreamcast.
+void * memcpy_32bit_shift(void *dest, const void *src, size_t len) {
+    if(!len)
+        return dest;
+
+    uint32_t shift = ((uintptr_t)src & 0x03) << 3; // bits to drop from each word
+
+    if(!shift)
+        return memcpy_32bit(dest, src, len);
+
+    const uint32_t *s = (const uint32_t *)((uintptr_t)src & ~(uintptr_t)0x03);
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t *d = (uint32_t *)dest;
+
+    uint32_t cur;
+    uint32_t next;
+
+    if(shift == 16) {
+        // xtrct Rm, Rn gives the middle 32 bits of Rm:Rn, which is exactly
+        // (next << 16) | (cur >> 16)
+        __asm__ volatile (
+            "mov.l @%[in]+, %[cur]\n\t" // cur = *(s++) (LS)
+            "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+            ".align 2\n"
+            "0:\n\t"
+            "mov.l @%[in]+, %[next]\n\t" // next = *(s++) (LS)
+            "xtrct %[next], %[cur]\n\t" // cur = (next << 16) | (cur >> 16) (EX)
+            "dt %[size]\n\t" // (--len) ? 0 -> T : 1 -> T (EX)
+            "mov.l %[cur], @%[out]\n\t" // *d = cur (LS)
+            "add #4, %[out]\n\t" // d++ (EX)
+            "bf.s 0b\n\t" // (BR)
+            " mov %[next], %[cur]\n" // cur = next (MT)
+            : [in] "+&r" ((uint32_t)s), [out] "+&r" ((uint32_t)d), [size] "+&r" (len),
+            [cur] "=&r" (cur), [next] "=&r" (next) // outputs
+            : // inputs
+            : "t", "memory" // clobbers
+        );
+    }
+    else {
+        // shld shifts right for negative counts
+        int32_t rshift = -(int32_t)shift;
+        int32_t lshift = 32 - shift;
+        uint32_t scratch;
+
+        __asm__ volatile (
+            "mov.l @%[in]+, %[cur]\n\t" // cur = *(s++) (LS)
+            "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+            ".align 2\n"
+            "0:\n\t"
+            "mov.l @%[in]+, %[next]\n\t" // next = *(s++) (LS)
+            "shld %[rshift], %[cur]\n\t" // cur >>= shift (EX)
+            "mov %[next], %[scratch]\n\t" // (MT)
+            "shld %[lshift], %[scratch]\n\t" // scratch = next << (32 - shift) (EX)
+            "or %[scratch], %[cur]\n\t" // (EX)
+            "dt %[size]\n\t" // (--len) ? 0 -> T : 1 -> T (EX)
+            "mov.l %[cur], @%[out]\n\t" // *d = cur (LS)
+            "add #4, %[out]\n\t" // d++ (EX)
+            "bf.s 0b\n\t" // (BR)
+            " mov %[next], %[cur]\n" // cur = next (MT)
+            : [in] "+&r" ((uint32_t)s), [out] "+&r" ((uint32_t)d), [size] "+&r" (len),
+            [cur] "=&r" (cur), [next] "=&r" (next), [scratch] "=&r" (scratch) // outputs
+            : [rshift] "r" (rshift), [lshift] "r" (lshift) // inputs
+            : "t", "memory" // clobbers
+        );
+    }
+#else
+    uint32_t *d = (uint32_t *)dest;
+    uint32_t cur = *s++;
+
+    do {
+        uint32_t next = *s++;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        *d++ = (cur << shift) | (next >> (32 - shift));
+#else
+        *d++ = (cur >> shift) | (next << (32 - shift));
+#endif
+        cur = next;
+    } while(--len);
+#endif
+
+    return dest;
+}
+
+// Smallest copy worth peeling head bytes for, smallest 8-byte aligned copy
+// worth stepping up to a cache line boundary for, and smallest mutually
+// misaligned copy worth the shift-and-merge kernel
+#define MOOP_PEEL_MIN 16
+#define MOOP_LINE_PEEL_MIN 64
+#define MOOP_SHIFT_MIN 16
+// Smallest line-aligned copy worth prefetching and allocating lines for
+#define MOOP_MOVCA_MIN 256
+
 void *memcpy_moop(void *dest, const void *src, size_t numbytes) {
     if (src == dest || numbytes == 0)
         return dest;
@@ -223,9 +482,53 @@ void *memcpy_moop(void *dest, const void *src, size_t numbytes) {
     void *returnval = dest;
     uint32_t offset = 0;
     uintptr_t ored = ((uintptr_t)src | (uintptr_t)dest);
+    uintptr_t xored = ((uintptr_t)src ^ (uintptr_t)dest);
+
+    // Co-aligned but off a boundary (e.g. both 3 bytes past an 8-byte
+    // boundary): copy a few head bytes so both land on the boundary and the
+    // wide kernels below get the body instead of singlebytes.
+    if((ored & 0x07) && numbytes >= MOOP_PEEL_MIN) {
+        if(!(xored & 0x07))
+            offset = -(uintptr_t)dest & 0x07;
+        else if(!(xored & 0x03))
+            offset = -(uintptr_t)dest & 0x03;
+
+        if(offset) {
+            memcpy_8bit(dest, src, offset);
+            dest = (char *)dest + offset;
+            src = (char *)src + offset;
+            numbytes -= offset;
+            ored = ((uintptr_t)src | (uintptr_t)dest);
+        }
+    }
+
+    // Step a large 8-byte aligned copy up to a 32-byte cache line boundary so
+    // the 32-byte kernel moves whole lines
+    if(!(ored & 0x07) && ((uintptr_t)dest & 0x1f) && numbytes >= MOOP_LINE_PEEL_MIN) {
+        offset = -(uintptr_t)dest & 0x1f;
+        memcpy_64bit(dest, src, offset >> 3);
+        dest = (char *)dest + offset;
+        src = (char *)src + offset;
+        numbytes -= offset;
+    }
+
+    // Large line-aligned copy: prefetch the source, allocate destination lines
+    if(!(ored & 0x07) && !((uintptr_t)dest & 0x1f) && numbytes >= MOOP_MOVCA_MIN) {
+        memcpy_64bit_32Bytes_movca(dest, src, numbytes >> 5);
+        offset = numbytes & -32;
+        dest = (char *)dest + offset;
+        src = (char *)src + offset;
+        numbytes &= 31; // clear the last 5 bits
 
+        if(numbytes >= 16)
+            goto sixteenbytes;
+        else if(numbytes >= 4)
+            goto fourbytes;
+        else if(numbytes)
+            goto singlebytes;
+    }
     // Check 8-byte alignment for 32-byte copy
-    if(!(ored & 0x07) && numbytes >= 32) {
+    else if(!(ored & 0x07) && numbytes >= 32) {
         memcpy_64bit_32Bytes(dest, src, numbytes >> 5);
         offset = numbytes & -32;
         dest = (char *)dest + offset;
@@ -265,6 +568,26 @@ fourbytes:
         if(numbytes)
             goto singlebytes;
     }
+    // Source and destination differ mod 4, so peeling can't line both up:
+    // align the destination and merge aligned source words
+    else if((xored & 0x03) && numbytes >= MOOP_SHIFT_MIN) {
+        offset = -(uintptr_t)dest & 0x03;
+        if(offset) {
+            memcpy_8bit(dest, src, offset);
+            dest = (char *)dest + offset;
+            src = (char *)src + offset;
+            numbytes -= offset;
+        }
+
+        memcpy_32bit_shift(dest, src, numbytes >> 2);
+        offset = numbytes & -4;
+        dest = (char *)dest + offset;
+        src = (char *)src + offset;
+        numbytes &= 3; // clear the last 2 bits
+
+        if(numbytes)
+            goto singlebytes;
+    }
     else {
         // numBytes always seems to be 1-3 when it reaches 
         // this else so lets just do it the old fashioned
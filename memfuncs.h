@@ -4,6 +4,7 @@
 //
 // This file provides function prototypes for memmove, memcpy, memset, and memcmp,
 // which are required by GCC when used in a freestanding environment.
+// It also provides strlen, memchr and strchr, searched a word at a time.
 //
 // NOTE:
 // If you need to move/copy memory between overlapping regions, use memmove instead of memcpy.
@@ -19,6 +20,50 @@
 #include <stddef.h>
 #include <stdint.h>
 
+//
+// PORTABILITY NOTE:
+// The kernels are SH4 inline assembly. When not compiling for SuperH (e.g. the
+// hosted Linux build of the benchmark), or when MEMFUNCS_PORTABLE is defined,
+// each function falls back to plain C with the same alignment and length
+// semantics. Build those fallbacks with -fno-tree-loop-distribute-patterns so
+// the compiler doesn't turn them back into calls to libc.
+//
+#if (defined(__sh__) || defined(__SH4__)) && !defined(MEMFUNCS_PORTABLE)
+#define MEMFUNCS_SH4_ASM 1
+#endif
+
+//
+// FPSCR NOTE:
+// fschg, fldi0 and the fmov.d pair moves are only defined with FPSCR.PR = 0.
+// That is the default under -m4-single, which KOS builds with. The Linux -m4
+// ABI defaults to double precision (PR = 1), so there every pair move loop
+// clears PR first and puts the caller's FPSCR back after. Elsewhere these
+// compile to nothing.
+//
+#if defined(MEMFUNCS_SH4_ASM) && !defined(__SH4_SINGLE__) && !defined(__SH4_SINGLE_ONLY__)
+#define MEMFUNCS_FPSCR_PR 0x00080000
+
+static inline uint32_t memfuncs_fpu_single(void) {
+    uint32_t fpscr;
+
+    __asm__ volatile ("sts fpscr, %0\n" : "=r" (fpscr));
+    __asm__ volatile ("lds %0, fpscr\n" : : "r" (fpscr & ~MEMFUNCS_FPSCR_PR) : "memory");
+    return fpscr;
+}
+
+static inline void memfuncs_fpu_restore(uint32_t fpscr) {
+    __asm__ volatile ("lds %0, fpscr\n" : : "r" (fpscr) : "memory");
+}
+#else
+static inline uint32_t memfuncs_fpu_single(void) {
+    return 0;
+}
+
+static inline void memfuncs_fpu_restore(uint32_t fpscr) {
+    (void)fpscr;
+}
+#endif
+
 //
 // USAGE INFORMATION:
 //
@@ -44,6 +89,15 @@
 // through in startup.S. As such, the AND mask 0x1fffffff comes in handy here.
 //
 
+// Measured constants from "membench latency", see memfuncs_tuning.h
+#include "memfuncs_tuning.h"
+
+// How far ahead of the current source line the prefetching kernels issue
+// pref, in bytes. Override with -DMEMFUNCS_PREF_DISTANCE=... when tuning.
+#ifndef MEMFUNCS_PREF_DISTANCE
+#define MEMFUNCS_PREF_DISTANCE (MEMFUNCS_PREF_LINES * 32)
+#endif
+
 // MEMCPY
 void * memcpy_8bit(void *dest, const void *src, size_t len);
 void * memcpy_16bit(void *dest, const void *src, size_t len);
@@ -51,6 +105,8 @@ void * memcpy_32bit(void *dest, const void *src, size_t len);
 void * memcpy_32bit_16Bytes(void *dest, const void *src, size_t len);
 void * memcpy_64bit(void *dest, const void *src, size_t len);
 void * memcpy_64bit_32Bytes(void *dest, const void *src, size_t len);
+void * memcpy_64bit_32Bytes_movca(void *dest, const void *src, size_t len); // dest 32-byte aligned
+void * memcpy_32bit_shift(void *dest, const void *src, size_t len); // dest 4-byte aligned, src any
 void * memcpy_moop(void *dest, const void *src, size_t numbytes);
 
 // MEMMOVE
@@ -58,6 +114,7 @@ void * memmove_8bit(void *dest, const void *src, size_t len);
 void * memmove_16bit(void *dest, const void *src, size_t len);
 void * memmove_32bit(void *dest, const void *src, size_t len);
 void * memmove_64bit(void *dest, const void *src, size_t len);
+void * memmove_64bit_32Bytes(void *dest, const void *src, size_t len);
 void * memmove_moop(void *dest, const void *src, size_t numbytes);
 
 // MEMSET
@@ -67,6 +124,51 @@ void * memset_32bit(void *dest, const uint32_t val, size_t len);
 void * memset_64bit(void *dest, const uint32_t val, size_t len);
 void * memset_zeroes_32bit(void *dest, size_t len);
 void * memset_zeroes_64bit(void *dest, size_t len);
+void * memset_64bit_32Bytes_movca(void *dest, const uint32_t val, size_t len); // dest 32-byte aligned
+void * memset_zeroes_64bit_32Bytes_movca(void *dest, size_t len); // dest 32-byte aligned
 void * memset_moop(void *dest, const uint32_t val, size_t numbytes);
 
+// MEMCMP
+// The _prefix kernels return how many leading words (or 32-byte blocks) of len
+// are equal instead of a memcmp result.
+int memcmp_8bit(const void *str1, const void *str2, size_t len);
+size_t memcmp_32bit_prefix(const void *str1, const void *str2, size_t len);
+size_t memcmp_64bit_32Bytes_prefix(const void *str1, const void *str2, size_t len);
+size_t memcmp_32bit_shift_prefix(const void *str1, const void *str2, size_t len); // str1 4-byte aligned, str2 any
+int memcmp_moop(const void *str1, const void *str2, size_t numbytes);
+
+// STRLEN, MEMCHR, STRCHR (memscan.c)
+// The _32bit kernels return the first aligned word holding the byte looked for
+// (or the zero terminator, for strlen and strchr), which the *_moop versions
+// then search byte by byte. memchr_32bit returns src + len words on no hit.
+const void * strlen_32bit(const void *str);
+const void * memchr_32bit(const void *src, const uint8_t c, size_t len);
+const void * strchr_32bit(const void *str, const uint8_t c);
+size_t strlen_moop(const char *str);
+void * memchr_moop(const void *src, int c, size_t numbytes);
+char * strchr_moop(const char *str, int c);
+
+// GENERATED KERNELS (memkernels.c)
+// memcpy_<w>bit_x<u>, memmove_<w>bit_x<u> and memset_<w>bit_x<u> move u
+// w-bit elements per loop iteration, so len is the number of blocks of
+// (w / 8) * u bytes, e.g. memcpy_32bit_x4 with a len of 2 copies 32 bytes.
+// Alignment is that of the width. memset takes the fill pattern as a full
+// 32-bit word and stores its low w bits (both halves for 64-bit).
+// memread_<w>bit_x<u> only loads, as the read bandwidth reference for the
+// roofline benchmark.
+// X(width in bits, unroll, bytes per iteration)
+#define MEMFUNCS_KERNEL_FAMILY(X) \
+    X(8, 1, 1) X(8, 2, 2) X(8, 4, 4) X(8, 8, 8) \
+    X(16, 1, 2) X(16, 2, 4) X(16, 4, 8) X(16, 8, 16) \
+    X(32, 1, 4) X(32, 2, 8) X(32, 4, 16) X(32, 8, 32) \
+    X(64, 1, 8) X(64, 2, 16) X(64, 4, 32) X(64, 8, 64)
+
+#define MEMFUNCS_KERNEL_PROTOTYPES(w, u, bytes) \
+    void * memcpy_##w##bit_x##u(void *dest, const void *src, size_t len); \
+    void * memmove_##w##bit_x##u(void *dest, const void *src, size_t len); \
+    void * memset_##w##bit_x##u(void *dest, const uint32_t val, size_t len); \
+    void memread_##w##bit_x##u(const void *src, size_t len);
+
+MEMFUNCS_KERNEL_FAMILY(MEMFUNCS_KERNEL_PROTOTYPES)
+
 #endif /* __MEMFUNCS_H_ */
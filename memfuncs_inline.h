@@ -0,0 +1,211 @@
+//==============================================================================
+//  SH4 Memory Functions: Inline Constant-Size Header
+//==============================================================================
+//
+// memcpy_inline and memset_inline expand to straight-line moves when the
+// length is a compile-time constant and the pointers are provably aligned, and
+// call memcpy_moop/memset_moop otherwise. Fixed-size struct copies then skip
+// the runtime alignment checks and dispatch entirely.
+//
+// Alignment is proved by the compiler, not checked at run time. It comes from
+// the pointed-to type (a struct s32 * is as aligned as struct s32, up to 8),
+// from objects declared with __attribute__((aligned(n))) when the compiler
+// can see them, and from the *_aligned variants, which promise it via
+// __builtin_assume_aligned. void and char pointers promise nothing. Passing a
+// pointer that doesn't meet its type's or the promised alignment will crash,
+// just like the fixed-width functions in memfuncs.h.
+//
+// USAGE:
+//   struct mat2 { float m[8]; } __attribute__((aligned(8)));
+//   void f(struct mat2 *d, const struct mat2 *s) {
+//       memcpy_inline(d, s, 32);               // four fmov.d pairs, no checks
+//   }
+//   memcpy_inline_aligned(dst, src, 12, 4);    // three mov.l pairs
+//   memcpy_inline(dst, src, len);              // variable len: memcpy_moop
+//
+
+#ifndef __MEMFUNCS_INLINE_H_
+#define __MEMFUNCS_INLINE_H_
+
+#include "memfuncs.h"
+
+// Longest constant length that is expanded inline. Longer copies are better
+// served by the loops in memcpy_moop/memset_moop.
+#ifndef MEMFUNCS_INLINE_MAX
+#define MEMFUNCS_INLINE_MAX 128
+#endif
+
+#define MEMFUNCS_ALWAYS_INLINE static inline __attribute__((always_inline))
+
+// May alias anything, so the straight-line moves work on any object type
+typedef uint32_t __attribute__((may_alias)) memfuncs_u32;
+typedef uint16_t __attribute__((may_alias)) memfuncs_u16;
+
+// 32 bytes, both pointers 8-byte aligned: four paired fmov.d loads and stores
+MEMFUNCS_ALWAYS_INLINE void memfuncs_inline_copy32(void *dest, const void *src) {
+#ifdef MEMFUNCS_SH4_ASM
+    _Complex float double_scratch;
+    _Complex float double_scratch2;
+    _Complex float double_scratch3;
+    _Complex float double_scratch4;
+
+    uint32_t fpscr = memfuncs_fpu_single();
+    __asm__ volatile (
+        "fschg\n\t" // Switch to pair move mode (FE)
+        "fmov.d @%[in]+, %[scratch]\n\t" // (LS)
+        "fmov.d @%[in]+, %[scratch2]\n\t" // (LS)
+        "fmov.d @%[in]+, %[scratch3]\n\t" // (LS)
+        "add #32, %[out]\n\t" // (EX)
+        "fmov.d @%[in]+, %[scratch4]\n\t" // (LS)
+        "fmov.d %[scratch4], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch3], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch2], @-%[out]\n\t" // (LS)
+        "fmov.d %[scratch], @-%[out]\n\t" // (LS)
+        "fschg\n" // Switch back to single move mode (FE)
+        : [in] "+&r" (src), [out] "+&r" (dest),
+        [scratch] "=&d" (double_scratch), [scratch2] "=&d" (double_scratch2), [scratch3] "=&d" (double_scratch3), [scratch4] "=&d" (double_scratch4) // outputs
+        : // inputs
+        : "memory" // clobbers
+    );
+    memfuncs_fpu_restore(fpscr);
+#else
+    typedef uint64_t __attribute__((may_alias)) memfuncs_u64;
+    const memfuncs_u64 *s = (const memfuncs_u64 *)src;
+    memfuncs_u64 *d = (memfuncs_u64 *)dest;
+
+    uint64_t scratch = s[0];
+    uint64_t scratch2 = s[1];
+    uint64_t scratch3 = s[2];
+    uint64_t scratch4 = s[3];
+    d[0] = scratch;
+    d[1] = scratch2;
+    d[2] = scratch3;
+    d[3] = scratch4;
+#endif
+}
+
+// Constant len, pointers aligned to at least align (1, 2, 4 or 8).
+// The loops have constant trip counts and unroll completely.
+MEMFUNCS_ALWAYS_INLINE void memfuncs_inline_copy(uint8_t *d, const uint8_t *s, size_t len, unsigned align) {
+    if(align >= 8) {
+        while(len >= 32) {
+            memfuncs_inline_copy32(d, s);
+            d += 32;
+            s += 32;
+            len -= 32;
+        }
+    }
+
+    if(align >= 4) {
+        while(len >= 4) {
+            *(memfuncs_u32 *)d = *(const memfuncs_u32 *)s;
+            d += 4;
+            s += 4;
+            len -= 4;
+        }
+    }
+
+    if(align >= 2) {
+        while(len >= 2) {
+            *(memfuncs_u16 *)d = *(const memfuncs_u16 *)s;
+            d += 2;
+            s += 2;
+            len -= 2;
+        }
+    }
+
+    while(len) {
+        *d++ = *s++;
+        len--;
+    }
+}
+
+MEMFUNCS_ALWAYS_INLINE void memfuncs_inline_set(uint8_t *d, uint32_t val, size_t len, unsigned align) {
+    if(align >= 4) {
+        while(len >= 4) {
+            *(memfuncs_u32 *)d = val;
+            d += 4;
+            len -= 4;
+        }
+    }
+
+    if(align >= 2) {
+        while(len >= 2) {
+            *(memfuncs_u16 *)d = (uint16_t)val;
+            d += 2;
+            len -= 2;
+        }
+    }
+
+    while(len) {
+        *d++ = (uint8_t)val;
+        len--;
+    }
+}
+
+// Largest power of two (up to 8) that the compiler can prove divides addr.
+// Only constant for named objects and __builtin_assume_aligned pointers.
+#define MEMFUNCS_KNOWN_ALIGN(addr) \
+    ((__builtin_constant_p((addr) & 7) && !((addr) & 7)) ? 8 : \
+     (__builtin_constant_p((addr) & 3) && !((addr) & 3)) ? 4 : \
+     (__builtin_constant_p((addr) & 1) && !((addr) & 1)) ? 2 : 1)
+
+// Alignment the type of *p guarantees, up to 8. 1 for void (a GCC extension)
+// and char pointers.
+#define MEMFUNCS_TYPE_ALIGN(p) (__alignof__(*(p)) < 8 ? (unsigned)__alignof__(*(p)) : 8u)
+
+// type_align is the alignment both pointers' types guarantee
+MEMFUNCS_ALWAYS_INLINE void * memfuncs_memcpy_inline(void *dest, const void *src, size_t numbytes,
+    unsigned type_align) {
+    if(__builtin_constant_p(numbytes) && numbytes <= MEMFUNCS_INLINE_MAX) {
+        unsigned align = MEMFUNCS_KNOWN_ALIGN((uintptr_t)dest | (uintptr_t)src);
+
+        if(type_align > align)
+            align = type_align;
+
+        // Without at least 4-byte alignment the byte loop isn't worth the code
+        if(align >= 4 || numbytes < 4) {
+            memfuncs_inline_copy((uint8_t *)dest, (const uint8_t *)src, numbytes, align);
+            return dest;
+        }
+    }
+
+    return memcpy_moop(dest, src, numbytes);
+}
+
+MEMFUNCS_ALWAYS_INLINE void * memfuncs_memset_inline(void *dest, int val, size_t numbytes, unsigned type_align) {
+    uint32_t pattern = (uint8_t)val * 0x01010101u;
+
+    if(__builtin_constant_p(numbytes) && numbytes <= MEMFUNCS_INLINE_MAX) {
+        unsigned align = MEMFUNCS_KNOWN_ALIGN((uintptr_t)dest);
+
+        if(type_align > align)
+            align = type_align;
+
+        if(align >= 4 || numbytes < 4) {
+            memfuncs_inline_set((uint8_t *)dest, pattern, numbytes, align);
+            return dest;
+        }
+    }
+
+    return memset_moop(dest, pattern, numbytes);
+}
+
+// Macros so the pointers' types, which the functions above can't see, count
+#define memcpy_inline(dest, src, numbytes) \
+    memfuncs_memcpy_inline((dest), (src), (numbytes), \
+        MEMFUNCS_TYPE_ALIGN(dest) < MEMFUNCS_TYPE_ALIGN(src) ? MEMFUNCS_TYPE_ALIGN(dest) : MEMFUNCS_TYPE_ALIGN(src))
+
+// val is a byte, like libc memset
+#define memset_inline(dest, val, numbytes) \
+    memfuncs_memset_inline((dest), (val), (numbytes), MEMFUNCS_TYPE_ALIGN(dest))
+
+// Same, with the caller promising align-byte alignment of both pointers
+// (align must be a constant 2, 4 or 8)
+#define memcpy_inline_aligned(dest, src, numbytes, align) \
+    memcpy_inline(__builtin_assume_aligned((dest), (align)), __builtin_assume_aligned((src), (align)), (numbytes))
+
+#define memset_inline_aligned(dest, val, numbytes, align) \
+    memset_inline(__builtin_assume_aligned((dest), (align)), (val), (numbytes))
+
+#endif /* __MEMFUNCS_INLINE_H_ */
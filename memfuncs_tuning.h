@@ -0,0 +1,10 @@
+// Default tuning: prefetch two lines ahead, the distance the prefetching
+// kernels were written with. There is no latency data for the Dreamcast yet.
+// Regenerate with "membench latency" on the target machine.
+
+#ifndef __MEMFUNCS_TUNING_H_
+#define __MEMFUNCS_TUNING_H_
+
+#define MEMFUNCS_PREF_LINES 2
+
+#endif /* __MEMFUNCS_TUNING_H_ */
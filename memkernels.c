@@ -0,0 +1,314 @@
+// Generated kernel family
+//
+// Every width x unroll combination of the copy, move and set loops, stamped
+// out from one template per operation by MEMFUNCS_KERNEL_FAMILY in memfuncs.h.
+// The hand-written kernels in memcpy.c, memmove.c and memset.c stay as they
+// are; these exist so "membench unroll" can show which unroll factor wins for
+// each operation and size before one of them is hand-tuned.
+//
+// The read templates load and discard, which only the benchmark has a use for.
+//
+// The copy and move templates follow memcpy_32bit_16Bytes: load the whole
+// block with post-increment, then store it back to front with pre-decrement.
+// The block is in registers before any of it is written, so the memmove
+// versions are safe for overlap at any distance in the right direction.
+//
+// Pipeline notes are /* */ comments here, since // would swallow the rest of
+// a macro body.
+//
+
+#include "memfuncs.h"
+
+// Per-width move instruction, scratch register class and C element type
+#define KERNEL_OP_8 "mov.b"
+#define KERNEL_OP_16 "mov.w"
+#define KERNEL_OP_32 "mov.l"
+#define KERNEL_OP_64 "fmov.d"
+
+#define KERNEL_REG_8 "r"
+#define KERNEL_REG_16 "r"
+#define KERNEL_REG_32 "r"
+#define KERNEL_REG_64 "d"
+
+#define KERNEL_SCRATCH_8 uint32_t
+#define KERNEL_SCRATCH_16 uint32_t
+#define KERNEL_SCRATCH_32 uint32_t
+#define KERNEL_SCRATCH_64 _Complex float
+
+#define KERNEL_TYPE_8 uint8_t
+#define KERNEL_TYPE_16 uint16_t
+#define KERNEL_TYPE_32 uint32_t
+#define KERNEL_TYPE_64 uint64_t
+
+// 64-bit moves run in pair move mode for the whole loop
+#define KERNEL_ENTER_8 ""
+#define KERNEL_ENTER_16 ""
+#define KERNEL_ENTER_32 ""
+#define KERNEL_ENTER_64 "fschg\n\t" /* Switch to pair move mode (FE) */
+
+#define KERNEL_LEAVE_8 ""
+#define KERNEL_LEAVE_16 ""
+#define KERNEL_LEAVE_32 ""
+#define KERNEL_LEAVE_64 "fschg\n" /* Switch back to single move mode (FE) */
+
+// and with FPSCR.PR clear, see memfuncs.h
+#define KERNEL_FPU_SAVE_8
+#define KERNEL_FPU_SAVE_16
+#define KERNEL_FPU_SAVE_32
+#define KERNEL_FPU_SAVE_64 uint32_t fpscr = memfuncs_fpu_single();
+
+#define KERNEL_FPU_RESTORE_8
+#define KERNEL_FPU_RESTORE_16
+#define KERNEL_FPU_RESTORE_32
+#define KERNEL_FPU_RESTORE_64 memfuncs_fpu_restore(fpscr);
+
+// memset source operand: the value register, or DR0 holding it twice
+#define KERNEL_SET_SRC_8 "%[in]"
+#define KERNEL_SET_SRC_16 "%[in]"
+#define KERNEL_SET_SRC_32 "%[in]"
+#define KERNEL_SET_SRC_64 "DR0"
+
+#define KERNEL_SET_ENTER_8 ""
+#define KERNEL_SET_ENTER_16 ""
+#define KERNEL_SET_ENTER_32 ""
+#define KERNEL_SET_ENTER_64 "lds %[in], fpul\n\t" "fsts fpul, fr0\n\t" "fsts fpul, fr1\n\t" KERNEL_ENTER_64
+
+#define KERNEL_SET_CLOBBERS_8 "t", "memory"
+#define KERNEL_SET_CLOBBERS_16 "t", "memory"
+#define KERNEL_SET_CLOBBERS_32 "t", "memory"
+#define KERNEL_SET_CLOBBERS_64 "t", "fr0", "fr1", "memory"
+
+#define KERNEL_PATTERN_8(val) ((uint8_t)(val))
+#define KERNEL_PATTERN_16(val) ((uint16_t)(val))
+#define KERNEL_PATTERN_32(val) ((uint32_t)(val))
+#define KERNEL_PATTERN_64(val) (((uint64_t)(val) << 32) | (val))
+
+// KERNEL_REP_u(M, a) expands M(a, 0) .. M(a, u-1). KERNEL_REP_DOWN_u(M, a)
+// expands M(a, u-1) down to M(a, 1), leaving element 0 for the delay slot.
+#define KERNEL_REP_1(M, a) M(a, 0)
+#define KERNEL_REP_2(M, a) KERNEL_REP_1(M, a) M(a, 1)
+#define KERNEL_REP_4(M, a) KERNEL_REP_2(M, a) M(a, 2) M(a, 3)
+#define KERNEL_REP_8(M, a) KERNEL_REP_4(M, a) M(a, 4) M(a, 5) M(a, 6) M(a, 7)
+
+#define KERNEL_REP_DOWN_1(M, a)
+#define KERNEL_REP_DOWN_2(M, a) M(a, 1)
+#define KERNEL_REP_DOWN_4(M, a) M(a, 3) M(a, 2) KERNEL_REP_DOWN_2(M, a)
+#define KERNEL_REP_DOWN_8(M, a) M(a, 7) M(a, 6) M(a, 5) M(a, 4) KERNEL_REP_DOWN_4(M, a)
+
+#ifdef MEMFUNCS_SH4_ASM
+
+#define KERNEL_DECL(type, n) type scratch##n;
+#define KERNEL_OPERAND(reg, n) , [scratch##n] "=&" reg (scratch##n)
+#define KERNEL_LOAD(op, n) op " @%[in]+, %[scratch" #n "]\n\t" /* (LS) */
+#define KERNEL_STORE(op, n) op " %[scratch" #n "], @-%[out]\n\t" /* (LS) */
+#define KERNEL_SET_STORE(w, n) KERNEL_OP_##w " " KERNEL_SET_SRC_##w ", @-%[out]\n\t" /* (LS) */
+
+// in/out at the start of the buffers, *dest++ = *src++ a block at a time
+#define KERNEL_FORWARD(w, u, bytes) \
+    KERNEL_FPU_SAVE_##w \
+    __asm__ volatile ( \
+        KERNEL_ENTER_##w \
+        "clrs\n" /* Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn */ \
+        ".align 2\n" \
+        "1:\n\t" \
+        KERNEL_REP_##u(KERNEL_LOAD, KERNEL_OP_##w) \
+        "add #" #bytes ", %[out]\n\t" /* (EX) */ \
+        "dt %[size]\n\t" /* while(--len) (EX) */ \
+        KERNEL_REP_DOWN_##u(KERNEL_STORE, KERNEL_OP_##w) \
+        KERNEL_STORE(KERNEL_OP_##w, 0) \
+        "bf.s 1b\n\t" /* (BR) */ \
+        " add #" #bytes ", %[out]\n\t" /* (EX) */ \
+        KERNEL_LEAVE_##w \
+        : [in] "+&r" (in), [out] "+&r" (out), [size] "+&r" (len) \
+        KERNEL_REP_##u(KERNEL_OPERAND, KERNEL_REG_##w) /* outputs */ \
+        : /* inputs */ \
+        : "t", "memory" /* clobbers */ \
+    ); \
+    KERNEL_FPU_RESTORE_##w
+
+// in/out at the end of the buffers, *--dest = *--src a block at a time.
+// There are no pre-decrement loads, so step back a block, load it forwards,
+// then step back over it again.
+#define KERNEL_BACKWARD(w, u, bytes) \
+    KERNEL_FPU_SAVE_##w \
+    __asm__ volatile ( \
+        KERNEL_ENTER_##w \
+        "clrs\n" /* Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn */ \
+        ".align 2\n" \
+        "1:\n\t" \
+        "add #-" #bytes ", %[in]\n\t" /* (EX) */ \
+        KERNEL_REP_##u(KERNEL_LOAD, KERNEL_OP_##w) \
+        "add #-" #bytes ", %[in]\n\t" /* (EX) */ \
+        "dt %[size]\n\t" /* while(--len) (EX) */ \
+        KERNEL_REP_DOWN_##u(KERNEL_STORE, KERNEL_OP_##w) \
+        "bf.s 1b\n\t" /* (BR) */ \
+        " " KERNEL_STORE(KERNEL_OP_##w, 0) \
+        KERNEL_LEAVE_##w \
+        : [in] "+&r" (in), [out] "+&r" (out), [size] "+&r" (len) \
+        KERNEL_REP_##u(KERNEL_OPERAND, KERNEL_REG_##w) /* outputs */ \
+        : /* inputs */ \
+        : "t", "memory" /* clobbers */ \
+    ); \
+    KERNEL_FPU_RESTORE_##w
+
+#define KERNEL_COPY_BODY(w, u, bytes) \
+    uint32_t in = (uint32_t)src; \
+    uint32_t out = (uint32_t)dest; \
+    KERNEL_REP_##u(KERNEL_DECL, KERNEL_SCRATCH_##w) \
+    KERNEL_FORWARD(w, u, bytes)
+
+#define KERNEL_MOVE_BODY(w, u, bytes) \
+    uint32_t in = (uint32_t)src; \
+    uint32_t out = (uint32_t)dest; \
+    KERNEL_REP_##u(KERNEL_DECL, KERNEL_SCRATCH_##w) \
+    if(in > out) { \
+        KERNEL_FORWARD(w, u, bytes) \
+    } \
+    else { \
+        in += bytes * len; \
+        out += bytes * len; \
+        KERNEL_BACKWARD(w, u, bytes) \
+    }
+
+#define KERNEL_READ_BODY(w, u, bytes) \
+    uint32_t in = (uint32_t)src; \
+    KERNEL_REP_##u(KERNEL_DECL, KERNEL_SCRATCH_##w) \
+    KERNEL_FPU_SAVE_##w \
+    __asm__ volatile ( \
+        KERNEL_ENTER_##w \
+        "clrs\n" /* Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn */ \
+        ".align 2\n" \
+        "1:\n\t" \
+        KERNEL_REP_##u(KERNEL_LOAD, KERNEL_OP_##w) \
+        "dt %[size]\n\t" /* while(--len) (EX) */ \
+        "bf 1b\n\t" /* (BR) */ \
+        KERNEL_LEAVE_##w \
+        : [in] "+&r" (in), [size] "+&r" (len) \
+        KERNEL_REP_##u(KERNEL_OPERAND, KERNEL_REG_##w) /* outputs */ \
+        : /* inputs */ \
+        : "t", "memory" /* clobbers */ \
+    ); \
+    KERNEL_FPU_RESTORE_##w
+
+// *--nextd = val, u stores per dt like memset_32bit
+#define KERNEL_SET_BODY(w, u, bytes) \
+    uint32_t out = (uint32_t)dest + bytes * len; \
+    KERNEL_FPU_SAVE_##w \
+    __asm__ volatile ( \
+        KERNEL_SET_ENTER_##w \
+        "dt %[size]\n\t" /* Decrement and test size here once to prevent extra jump (EX 1) */ \
+        "clrs\n" /* Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn */ \
+        ".align 2\n" \
+        "1:\n\t" \
+        KERNEL_REP_##u(KERNEL_SET_STORE, w) \
+        "bf.s 1b\n\t" /* (BR 1/2) */ \
+        " dt %[size]\n\t" /* (--len) ? 0 -> T : 1 -> T (EX 1) */ \
+        KERNEL_LEAVE_##w \
+        : [out] "+r" (out), [size] "+&r" (len) /* outputs */ \
+        : [in] "r" (val) /* inputs */ \
+        : KERNEL_SET_CLOBBERS_##w /* clobbers */ \
+    ); \
+    KERNEL_FPU_RESTORE_##w
+
+#else
+
+#define KERNEL_COPY_BODY(w, u, bytes) \
+    const KERNEL_TYPE_##w *s = (const KERNEL_TYPE_##w *)src; \
+    KERNEL_TYPE_##w *d = (KERNEL_TYPE_##w *)dest; \
+    do { \
+        KERNEL_TYPE_##w scratch[u]; \
+        unsigned i; \
+        for(i = 0; i < u; i++) \
+            scratch[i] = s[i]; \
+        for(i = 0; i < u; i++) \
+            d[i] = scratch[i]; \
+        s += u; \
+        d += u; \
+    } while(--len);
+
+#define KERNEL_MOVE_BODY(w, u, bytes) \
+    const KERNEL_TYPE_##w *s = (const KERNEL_TYPE_##w *)src; \
+    KERNEL_TYPE_##w *d = (KERNEL_TYPE_##w *)dest; \
+    if(s > d) { \
+        do { \
+            KERNEL_TYPE_##w scratch[u]; \
+            unsigned i; \
+            for(i = 0; i < u; i++) \
+                scratch[i] = s[i]; \
+            for(i = 0; i < u; i++) \
+                d[i] = scratch[i]; \
+            s += u; \
+            d += u; \
+        } while(--len); \
+    } \
+    else { \
+        s += u * len; \
+        d += u * len; \
+        do { \
+            KERNEL_TYPE_##w scratch[u]; \
+            unsigned i; \
+            s -= u; \
+            d -= u; \
+            for(i = 0; i < u; i++) \
+                scratch[i] = s[i]; \
+            for(i = u; i--; ) \
+                d[i] = scratch[i]; \
+        } while(--len); \
+    }
+
+// volatile, or the loads would be dropped
+#define KERNEL_READ_BODY(w, u, bytes) \
+    const volatile KERNEL_TYPE_##w *s = (const volatile KERNEL_TYPE_##w *)src; \
+    do { \
+        unsigned i; \
+        for(i = 0; i < u; i++) \
+            (void)s[i]; \
+        s += u; \
+    } while(--len);
+
+#define KERNEL_SET_BODY(w, u, bytes) \
+    KERNEL_TYPE_##w pattern = KERNEL_PATTERN_##w(val); \
+    KERNEL_TYPE_##w *nextd = (KERNEL_TYPE_##w *)dest + u * len; \
+    do { \
+        unsigned i; \
+        for(i = 0; i < u; i++) \
+            *--nextd = pattern; \
+    } while(--len);
+
+#endif
+
+#define KERNEL_MEMCPY(w, u, bytes) \
+void * memcpy_##w##bit_x##u(void *dest, const void *src, size_t len) { \
+    if(!len) \
+        return dest; \
+    KERNEL_COPY_BODY(w, u, bytes) \
+    return dest; \
+}
+
+#define KERNEL_MEMMOVE(w, u, bytes) \
+void * memmove_##w##bit_x##u(void *dest, const void *src, size_t len) { \
+    if(!len || src == dest) \
+        return dest; \
+    KERNEL_MOVE_BODY(w, u, bytes) \
+    return dest; \
+}
+
+#define KERNEL_MEMSET(w, u, bytes) \
+void * memset_##w##bit_x##u(void *dest, const uint32_t val, size_t len) { \
+    if(!len) \
+        return dest; \
+    KERNEL_SET_BODY(w, u, bytes) \
+    return dest; \
+}
+
+#define KERNEL_MEMREAD(w, u, bytes) \
+void memread_##w##bit_x##u(const void *src, size_t len) { \
+    if(!len) \
+        return; \
+    KERNEL_READ_BODY(w, u, bytes) \
+}
+
+MEMFUNCS_KERNEL_FAMILY(KERNEL_MEMCPY)
+MEMFUNCS_KERNEL_FAMILY(KERNEL_MEMMOVE)
+MEMFUNCS_KERNEL_FAMILY(KERNEL_MEMSET)
+MEMFUNCS_KERNEL_FAMILY(KERNEL_MEMREAD)
@@ -19,6 +19,7 @@ void * memmove_8bit(void *dest, const void *src, size_t len) {
     const uint8_t *s = (uint8_t *)src;
     uint8_t *d = (uint8_t *)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     if (s > d) {
         uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
         // This will underflow and be like adding a negative offset
@@ -58,6 +59,21 @@ void * memmove_8bit(void *dest, const void *src, size_t len) {
             : "t", "memory" // clobbers
         );
     }
+#else
+    if (s > d) {
+        do {
+            *d++ = *s++;
+        } while(--len);
+    }
+    else { // s < d
+        s += len;
+        d += len;
+
+        do {
+            *--d = *--s;
+        } while(--len);
+    }
+#endif
 
     return dest;
 }
@@ -72,6 +88,7 @@ void * memmove_16bit(void *dest, const void *src, size_t len) {
     const uint16_t* s = (uint16_t*)src;
     uint16_t* d = (uint16_t*)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     if (s > d) {
         uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
         // This will underflow and be like adding a negative offset
@@ -111,6 +128,21 @@ void * memmove_16bit(void *dest, const void *src, size_t len) {
             : "t", "memory" // clobbers
         );
     }
+#else
+    if (s > d) {
+        do {
+            *d++ = *s++;
+        } while(--len);
+    }
+    else { // s < d
+        s += len;
+        d += len;
+
+        do {
+            *--d = *--s;
+        } while(--len);
+    }
+#endif
 
     return dest;
 }
@@ -125,6 +157,7 @@ void * memmove_32bit(void *dest, const void *src, size_t len) {
     const uint32_t* s = (uint32_t*)src;
     uint32_t* d = (uint32_t*)dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     if (s > d) {
         uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
         // This will underflow and be like adding a negative offset
@@ -163,6 +196,21 @@ void * memmove_32bit(void *dest, const void *src, size_t len) {
             : "t", "memory" // clobbers
         );
     }
+#else
+    if (s > d) {
+        do {
+            *d++ = *s++;
+        } while(--len);
+    }
+    else { // s < d
+        s += len;
+        d += len;
+
+        do {
+            *--d = *--s;
+        } while(--len);
+    }
+#endif
 
     return dest;
 }
@@ -174,6 +222,7 @@ void * memmove_64bit(void *dest, const void *src, size_t len) {
     if(!len)
         return dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     const _Complex float* s = (_Complex float*)src;
     _Complex float* d = (_Complex float*)dest;
 
@@ -183,6 +232,7 @@ void * memmove_64bit(void *dest, const void *src, size_t len) {
         uint32_t diff = (uint32_t)d - (uint32_t)(s + 1); // extra offset because input gets incremented before output is calculated
         // This will underflow and be like adding a negative offset
 
+        uint32_t fpscr = memfuncs_fpu_single();
         __asm__ volatile (
             "fschg\n\t"
             "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
@@ -197,6 +247,7 @@ void * memmove_64bit(void *dest, const void *src, size_t len) {
             : [offset] "z" (diff) // inputs
             : "t", "memory" // clobbers
         );
+        memfuncs_fpu_restore(fpscr);
     }
     else { // s < d
         _Complex float *nextd = d + len;
@@ -204,6 +255,7 @@ void * memmove_64bit(void *dest, const void *src, size_t len) {
         uint32_t diff = (uint32_t)s - (uint32_t)(d + 1); // extra offset because input calculation occurs before output is decremented
         // This will underflow and be like adding a negative offset
 
+        uint32_t fpscr = memfuncs_fpu_single();
         __asm__ volatile (
             "fschg\n\t"
             "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
@@ -218,7 +270,145 @@ void * memmove_64bit(void *dest, const void *src, size_t len) {
             : [offset] "z" (diff) // inputs
             : "t", "memory" // clobbers
         );
+        memfuncs_fpu_restore(fpscr);
     }
+#else
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t *d = (uint64_t *)dest;
+
+    if (s > d) {
+        do {
+            *d++ = *s++;
+        } while(--len);
+    }
+    else { // s < d
+        s += len;
+        d += len;
+
+        do {
+            *--d = *--s;
+        } while(--len);
+    }
+#endif
+
+    return dest;
+}
+
+// 32 Bytes at a time
+// Len is (# of total bytes/32), so it's "# of 32 Bytes"
+// Source and destination buffers must both be 8-byte aligned
+// Each block is loaded completely before any of it is stored, so overlap at
+// any distance is fine as long as the direction is right.
+void * memmove_64bit_32Bytes(void *dest, const void *src, size_t len) {
+    if(!len)
+        return dest;
+
+#ifdef MEMFUNCS_SH4_ASM
+    const _Complex float* s = (_Complex float*)src;
+    _Complex float* d = (_Complex float*)dest;
+
+    _Complex float double_scratch;
+    _Complex float double_scratch2;
+    _Complex float double_scratch3;
+    _Complex float double_scratch4;
+
+    if (s > d) {
+        uint32_t fpscr = memfuncs_fpu_single();
+        __asm__ volatile (
+            "fschg\n\t" // Switch to pair move mode (FE)
+            "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+            ".align 2\n"
+            "1:\n\t"
+            // *dest++ = *src++
+            "fmov.d @%[in]+, %[scratch]\n\t" // (LS)
+            "fmov.d @%[in]+, %[scratch2]\n\t" // (LS)
+            "fmov.d @%[in]+, %[scratch3]\n\t" // (LS)
+            "add #32, %[out]\n\t" // (EX)
+            "fmov.d @%[in]+, %[scratch4]\n\t" // (LS)
+            "dt %[size]\n\t" // while(--len) (EX)
+            "fmov.d %[scratch4], @-%[out]\n\t" // (LS)
+            "fmov.d %[scratch3], @-%[out]\n\t" // (LS)
+            "fmov.d %[scratch2], @-%[out]\n\t" // (LS)
+            "fmov.d %[scratch], @-%[out]\n\t" // (LS)
+            "bf.s 1b\n\t" // (BR)
+            " add #32, %[out]\n\t" // (EX)
+            "fschg\n" // Switch back to single move mode (FE)
+            : [in] "+&r" ((uint32_t)s), [out] "+&r" ((uint32_t)d), [size] "+&r" (len),
+            [scratch] "=&d" (double_scratch), [scratch2] "=&d" (double_scratch2), [scratch3] "=&d" (double_scratch3), [scratch4] "=&d" (double_scratch4) // outputs
+            : // inputs
+            : "t", "memory" // clobbers
+        );
+        memfuncs_fpu_restore(fpscr);
+    }
+    else { // s < d
+        const _Complex float *nexts = s + 4 * len;
+        _Complex float *nextd = d + 4 * len;
+
+        // There are no pre-decrement loads, so step back a block, load it
+        // forwards, then step back over it again
+        uint32_t fpscr = memfuncs_fpu_single();
+        __asm__ volatile (
+            "fschg\n\t" // Switch to pair move mode (FE)
+            "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+            ".align 2\n"
+            "1:\n\t"
+            // *--nextd = *--nexts
+            "add #-32, %[in_end]\n\t" // (EX)
+            "fmov.d @%[in_end]+, %[scratch]\n\t" // (LS)
+            "fmov.d @%[in_end]+, %[scratch2]\n\t" // (LS)
+            "fmov.d @%[in_end]+, %[scratch3]\n\t" // (LS)
+            "fmov.d @%[in_end]+, %[scratch4]\n\t" // (LS)
+            "add #-32, %[in_end]\n\t" // (EX)
+            "dt %[size]\n\t" // while(--len) (EX)
+            "fmov.d %[scratch4], @-%[out_end]\n\t" // (LS)
+            "fmov.d %[scratch3], @-%[out_end]\n\t" // (LS)
+            "fmov.d %[scratch2], @-%[out_end]\n\t" // (LS)
+            "bf.s 1b\n\t" // (BR)
+            " fmov.d %[scratch], @-%[out_end]\n\t" // (LS)
+            "fschg\n" // Switch back to single move mode (FE)
+            : [in_end] "+&r" ((uint32_t)nexts), [out_end] "+&r" ((uint32_t)nextd), [size] "+&r" (len),
+            [scratch] "=&d" (double_scratch), [scratch2] "=&d" (double_scratch2), [scratch3] "=&d" (double_scratch3), [scratch4] "=&d" (double_scratch4) // outputs
+            : // inputs
+            : "t", "memory" // clobbers
+        );
+        memfuncs_fpu_restore(fpscr);
+    }
+#else
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t *d = (uint64_t *)dest;
+
+    if (s > d) {
+        do {
+            uint64_t scratch = s[0];
+            uint64_t scratch2 = s[1];
+            uint64_t scratch3 = s[2];
+            uint64_t scratch4 = s[3];
+            d[0] = scratch;
+            d[1] = scratch2;
+            d[2] = scratch3;
+            d[3] = scratch4;
+            s += 4;
+            d += 4;
+        } while(--len);
+    }
+    else { // s < d
+        s += 4 * len;
+        d += 4 * len;
+
+        do {
+            s -= 4;
+            d -= 4;
+            uint64_t scratch = s[0];
+            uint64_t scratch2 = s[1];
+            uint64_t scratch3 = s[2];
+            uint64_t scratch4 = s[3];
+            d[3] = scratch4;
+            d[2] = scratch3;
+            d[1] = scratch2;
+            d[0] = scratch;
+        } while(--len);
+    }
+#endif
 
     return dest;
 }
@@ -227,42 +417,92 @@ void * memmove_moop(void *dest, const void *src, size_t numbytes) {
     if (src == dest || numbytes == 0)
         return dest;
 
-    void *returnval = dest;
+    // Disjoint ranges don't need a direction at all, so they can take every
+    // memcpy_moop fast path (shift-and-merge, movca.l lines)
+    if((uintptr_t)dest + numbytes <= (uintptr_t)src || (uintptr_t)src + numbytes <= (uintptr_t)dest)
+        return memcpy_moop(dest, src, numbytes);
+
+    char *d = (char *)dest;
+    const char *s = (const char *)src;
     uint32_t offset = 0;
-    uintptr_t ored = ((uintptr_t)src | (uintptr_t)dest);
-
-    // Check 8-byte alignment for 8-byte copy
-    if(!(ored & 0x07) && numbytes >= 8) {
-        memmove_64bit(dest, src, numbytes >> 3);
-        offset = numbytes & -8;
-        dest = (char *)dest + offset;
-        src = (char *)src + offset;
-        numbytes &= 7; // clear the last 3 bits
-
-        if(numbytes >= 4)
-            goto fourbytes;
-        else if(numbytes)
-            goto singlebytes;
+    uintptr_t xored = ((uintptr_t)src ^ (uintptr_t)dest);
+
+    // Widest boundary both pointers can reach together. Mutually misaligned
+    // buffers (mask 0) go through memmove_8bit in one piece.
+    uint32_t mask = !(xored & 0x07) ? 0x07 : !(xored & 0x03) ? 0x03 : 0;
+
+    if (s > d) {
+        // Forwards: head bytes up to the boundary, the widest kernels, tail.
+        offset = -(uintptr_t)d & mask;
+        if(offset > numbytes)
+            offset = numbytes;
+        memmove_8bit(d, s, offset);
+        d += offset;
+        s += offset;
+        numbytes -= offset;
+
+        if(mask == 0x07) {
+            memmove_64bit_32Bytes(d, s, numbytes >> 5);
+            offset = numbytes & -32;
+            d += offset;
+            s += offset;
+            numbytes &= 31; // clear the last 5 bits
+
+            memmove_64bit(d, s, numbytes >> 3);
+            offset = numbytes & -8;
+            d += offset;
+            s += offset;
+            numbytes &= 7; // clear the last 3 bits
+        }
+
+        if(mask) {
+            memmove_32bit(d, s, numbytes >> 2);
+            offset = numbytes & -4;
+            d += offset;
+            s += offset;
+            numbytes &= 3; // clear the last 2 bits
+        }
+
+        memmove_8bit(d, s, numbytes);
     }
-    // Check 4-byte alignment for 4-byte copy
-    else if(!(ored & 0x03) && numbytes >= 4) {
-fourbytes:
-        memmove_32bit(dest, src, numbytes >> 2);
-        offset = numbytes & -4;
-        dest = (char *)dest + offset;
-        src = (char *)src + offset;
-        numbytes &= 3; // clear the last 2 bits
-
-        if(numbytes)
-            goto singlebytes;
+    else { // s < d
+        // Backwards: the same steps mirrored, starting from the end. Each
+        // step only reads source bytes below everything already written.
+        char *nextd = d + numbytes;
+        const char *nexts = s + numbytes;
+
+        offset = (uintptr_t)nextd & mask;
+        if(offset > numbytes)
+            offset = numbytes;
+        nextd -= offset;
+        nexts -= offset;
+        memmove_8bit(nextd, nexts, offset);
+        numbytes -= offset;
+
+        if(mask == 0x07) {
+            offset = numbytes & -32;
+            nextd -= offset;
+            nexts -= offset;
+            memmove_64bit_32Bytes(nextd, nexts, numbytes >> 5);
+            numbytes &= 31; // clear the last 5 bits
+
+            offset = numbytes & -8;
+            nextd -= offset;
+            nexts -= offset;
+            memmove_64bit(nextd, nexts, numbytes >> 3);
+            numbytes &= 7; // clear the last 3 bits
+        }
+
+        if(mask) {
+            offset = numbytes & -4;
+            nextd -= offset;
+            nexts -= offset;
+            memmove_32bit(nextd, nexts, numbytes >> 2);
+            numbytes &= 3; // clear the last 2 bits
+        }
+
+        memmove_8bit(d, s, numbytes);
     }
-    else {
-        // numBytes always seems to be 1-3 when it reaches 
-        // this else so lets just do it the old fashioned
-        // way
-singlebytes:
-        memmove_8bit(dest, src, numbytes);
-    }  
-
-    return returnval;
+
+    return dest;
 }
@@ -0,0 +1,204 @@
+// Public Domain
+// Compile with GCC -O3 for best performance
+
+#include "memfuncs.h"
+
+//
+// Byte searches a word at a time: strlen, memchr and strchr.
+//
+// SH4's cmp/str Rm, Rn sets T if any of the four bytes of Rm equals the byte
+// in the same position of Rn, so one instruction tells whether a word holds a
+// zero (against a zero register) or a given character (against the character
+// in all four bytes). The word kernels only find the first word with a hit;
+// the *_moop functions then look at its bytes, so that is only paid once.
+//
+// Elsewhere the same test is the usual bit trick: (v - 0x01010101) & ~v &
+// 0x80808080 is nonzero exactly when some byte of v is zero, and v ^ pattern
+// has a zero byte wherever v has the character.
+//
+// The kernels read whole aligned words, so they may read up to 3 bytes past
+// the end of a string. An aligned word never crosses a page or cache line, so
+// that can't fault, but memory checkers will see it.
+//
+
+#ifndef MEMFUNCS_SH4_ASM
+static inline uint32_t memscan_zero_bytes(uint32_t v) {
+    return (v - 0x01010101u) & ~v & 0x80808080u;
+}
+#endif
+
+// Find the first 4-byte word holding a zero byte
+// Returns that word's address
+// Source must be 4-byte aligned
+const void * strlen_32bit(const void *str) {
+    const uint32_t *s = (const uint32_t *)str;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t w;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.l @%[s]+, %[w]\n\t" // w = *(s++) (LS)
+        "cmp/str %[zero], %[w]\n\t" // Any byte of w zero ? 1 -> T : 0 -> T (MT)
+        "bf 0b\n" // (BR)
+        : [s] "+&r" ((uint32_t)s), [w] "=&r" (w) // outputs
+        : [zero] "r" (0) // inputs
+        : "t", "memory" // clobbers
+    );
+
+    return s - 1; // s is one word past the hit
+#else
+    while(!memscan_zero_bytes(*s))
+        s++;
+
+    return s;
+#endif
+}
+
+// Find the first 4-byte word holding the byte c
+// Len is (# of total bytes/4), so it's "# of 32-bits"
+// Returns that word's address, or src + len words if there is none
+// Source must be 4-byte aligned
+const void * memchr_32bit(const void *src, const uint8_t c, size_t len) {
+    const uint32_t *s = (const uint32_t *)src;
+    uint32_t pattern = c * 0x01010101u;
+
+    if(!len)
+        return src;
+
+    size_t left = len;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t w;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.l @%[s]+, %[w]\n\t" // w = *(s++) (LS)
+        "cmp/str %[pattern], %[w]\n\t" // Any byte of w == c ? 1 -> T : 0 -> T (MT)
+        "bt 1f\n\t" // Hit, left counts this word and the ones after it (BR)
+        "dt %[size]\n\t" // (--left) ? 0 -> T : 1 -> T (EX)
+        "bf 0b\n" // (BR)
+        "1:\n"
+        : [s] "+&r" ((uint32_t)s), [size] "+&r" (left), [w] "=&r" (w) // outputs
+        : [pattern] "r" (pattern) // inputs
+        : "t", "memory" // clobbers
+    );
+#else
+    while(left && !memscan_zero_bytes(s[len - left] ^ pattern))
+        left--;
+#endif
+
+    return (const uint32_t *)src + (len - left);
+}
+
+// Find the first 4-byte word holding either the byte c or a zero byte
+// Returns that word's address
+// Source must be 4-byte aligned
+const void * strchr_32bit(const void *str, const uint8_t c) {
+    const uint32_t *s = (const uint32_t *)str;
+    uint32_t pattern = c * 0x01010101u;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t w;
+
+    __asm__ volatile (
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "0:\n\t"
+        "mov.l @%[s]+, %[w]\n\t" // w = *(s++) (LS)
+        "cmp/str %[zero], %[w]\n\t" // Any byte of w zero ? 1 -> T : 0 -> T (MT)
+        "bt 1f\n\t" // (BR)
+        "cmp/str %[pattern], %[w]\n\t" // Any byte of w == c ? 1 -> T : 0 -> T (MT)
+        "bf 0b\n" // (BR)
+        "1:\n"
+        : [s] "+&r" ((uint32_t)s), [w] "=&r" (w) // outputs
+        : [zero] "r" (0), [pattern] "r" (pattern) // inputs
+        : "t", "memory" // clobbers
+    );
+
+    return s - 1; // s is one word past the hit
+#else
+    while(!(memscan_zero_bytes(*s) | memscan_zero_bytes(*s ^ pattern)))
+        s++;
+
+    return s;
+#endif
+}
+
+//
+// Moop versions
+//
+
+// Below this, stepping to alignment costs more than the word loop saves
+#define MOOP_SCAN_MIN 8
+
+size_t strlen_moop(const char *str) {
+    const char *s = str;
+
+    // Head bytes up to a 4-byte boundary
+    while((uintptr_t)s & 0x03) {
+        if(!*s)
+            return s - str;
+        s++;
+    }
+
+    // The word with the terminator, which is at most 3 bytes in
+    s = (const char *)strlen_32bit(s);
+    while(*s)
+        s++;
+
+    return s - str;
+}
+
+void * memchr_moop(const void *src, int c, size_t numbytes) {
+    const uint8_t *s = (const uint8_t *)src;
+    uint8_t ch = (uint8_t)c;
+
+    if(numbytes >= MOOP_SCAN_MIN) {
+        while((uintptr_t)s & 0x03) {
+            if(*s == ch)
+                return (void *)s;
+            s++;
+            numbytes--;
+        }
+
+        const uint8_t *hit = (const uint8_t *)memchr_32bit(s, ch, numbytes >> 2);
+        numbytes -= hit - s;
+        s = hit;
+    }
+
+    // The word with the hit, or the last 0-3 bytes
+    while(numbytes--) {
+        if(*s == ch)
+            return (void *)s;
+        s++;
+    }
+
+    return NULL;
+}
+
+char * strchr_moop(const char *str, int c) {
+    const char *s = str;
+    char ch = (char)c;
+
+    while((uintptr_t)s & 0x03) {
+        if(*s == ch)
+            return (char *)s;
+        if(!*s)
+            return NULL;
+        s++;
+    }
+
+    // The word with the character or the terminator. Checking the character
+    // first makes strchr(str, 0) find the terminator.
+    for(s = (const char *)strchr_32bit(s, (uint8_t)ch); ; s++) {
+        if(*s == ch)
+            return (char *)s;
+        if(!*s)
+            return NULL;
+    }
+}
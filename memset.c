@@ -11,6 +11,7 @@ void * memset_8bit(void *dest, const uint8_t val, size_t len) {
     uint8_t * d = (uint8_t*)dest;
     uint8_t * nextd = d + len;
 
+#ifdef MEMFUNCS_SH4_ASM
     __asm__ volatile (
         "clrs\n\t" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
         "dt %[size]\n" // Decrement and test size here once to prevent extra jump (EX 1)
@@ -24,6 +25,11 @@ void * memset_8bit(void *dest, const uint8_t val, size_t len) {
         : [in] "r" (val) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *--nextd = val;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -38,6 +44,7 @@ void * memset_16bit(void *dest, const uint16_t val, size_t len) {
     uint16_t * d = (uint16_t*)dest;
     uint16_t * nextd = d + len;
 
+#ifdef MEMFUNCS_SH4_ASM
     __asm__ volatile (
         "clrs\n\t" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
         "dt %[size]\n" // Decrement and test size here once to prevent extra jump (EX 1)
@@ -51,6 +58,11 @@ void * memset_16bit(void *dest, const uint16_t val, size_t len) {
         : [in] "r" (val) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *--nextd = val;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -65,6 +77,7 @@ void * memset_32bit(void *dest, const uint32_t val, size_t len) {
     uint32_t * d = (uint32_t*)dest;
     uint32_t * nextd = d + len;
 
+#ifdef MEMFUNCS_SH4_ASM
     __asm__ volatile (
         "clrs\n\t" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
         "dt %[size]\n" // Decrement and test size here once to prevent extra jump (EX 1)
@@ -78,6 +91,11 @@ void * memset_32bit(void *dest, const uint32_t val, size_t len) {
         : [in] "r" (val) // inputs
         : "t", "memory" // clobbers
     );
+#else
+    do {
+        *--nextd = val;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -90,9 +108,11 @@ void * memset_64bit(void *dest, const uint32_t val, size_t len) {
     if(!len)
         return dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     _Complex float * d = (_Complex float*)dest;
     _Complex float * nextd = d + len;
 
+    uint32_t fpscr = memfuncs_fpu_single();
     __asm__ volatile (
         "lds %[in], fpul\n\t" // (LS)
         "fsts fpul, fr0\n\t"
@@ -111,6 +131,16 @@ void * memset_64bit(void *dest, const uint32_t val, size_t len) {
         : [in] "r" (val) // inputs
         : "t", "fr0", "fr1", "memory" // clobbers
     );
+    memfuncs_fpu_restore(fpscr);
+#else
+    uint64_t * d = (uint64_t*)dest;
+    uint64_t * nextd = d + len;
+    uint64_t val64 = ((uint64_t)val << 32) | val;
+
+    do {
+        *--nextd = val64;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -122,11 +152,13 @@ void * memset_zeroes_32bit(void *dest, size_t len) {
     if(!len)
         return dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     float * d = (float*)dest;
     float * nextd = d + len;
 
     float float_scratch;
 
+    uint32_t fpscr = memfuncs_fpu_single();
     __asm__ volatile (
         "fldi0 %[scratch]\n\t"
         "dt %[size]\n\t" // Decrement and test size here once to prevent extra jump (EX 1)
@@ -141,6 +173,15 @@ void * memset_zeroes_32bit(void *dest, size_t len) {
         : // inputs
         : "t", "memory" // clobbers
     );
+    memfuncs_fpu_restore(fpscr);
+#else
+    uint32_t * d = (uint32_t*)dest;
+    uint32_t * nextd = d + len;
+
+    do {
+        *--nextd = 0;
+    } while(--len);
+#endif
 
     return dest;
 }
@@ -152,9 +193,11 @@ void * memset_zeroes_64bit(void *dest, size_t len) {
     if(!len)
         return dest;
 
+#ifdef MEMFUNCS_SH4_ASM
     _Complex float * d = (_Complex float*)dest;
     _Complex float * nextd = d + len;
 
+    uint32_t fpscr = memfuncs_fpu_single();
     __asm__ volatile (
         "fldi0 fr0\n\t"
         "fldi0 fr1\n\t"
@@ -172,10 +215,123 @@ void * memset_zeroes_64bit(void *dest, size_t len) {
         : // inputs
         : "t", "fr0", "fr1", "memory" // clobbers
     );
+    memfuncs_fpu_restore(fpscr);
+#else
+    uint64_t * d = (uint64_t*)dest;
+    uint64_t * nextd = d + len;
+
+    do {
+        *--nextd = 0;
+    } while(--len);
+#endif
 
     return dest;
 }
 
+// 32-bit input --> 32 bytes (one cache line) at a time
+// Len is (# of total bytes/32), so it's "# of 32 Bytes"
+// Each line is claimed with movca.l first, so it is never read in from RAM
+// just to be overwritten
+// Destination must be 32-byte aligned
+void * memset_64bit_32Bytes_movca(void *dest, const uint32_t val, size_t len) {
+    if(!len)
+        return dest;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t * d = (uint32_t*)dest;
+
+    uint32_t fpscr = memfuncs_fpu_single();
+    __asm__ volatile (
+        "lds %[in], fpul\n\t" // (LS)
+        "fsts fpul, fr0\n\t"
+        "fsts fpul, fr1\n\t"
+        "fschg\n\t" // Switch to pair move mode (FE)
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "1:\n\t"
+        "movca.l %[in], @%[out]\n\t" // Allocate the line and set its first 4 bytes (LS)
+        "add #32, %[out]\n\t" // (EX)
+        "dt %[size]\n\t" // (--len) ? 0 -> T : 1 -> T (EX)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "bf.s 1b\n\t" // (BR)
+        " add #32, %[out]\n\t" // (EX)
+        "fschg\n" // Switch back to single move mode (FE)
+        : [out] "+&r" ((uint32_t)d), [size] "+&r" (len) // outputs
+        : [in] "z" (val) // inputs
+        : "t", "fr0", "fr1", "memory" // clobbers
+    );
+    memfuncs_fpu_restore(fpscr);
+#else
+    uint64_t * d = (uint64_t*)dest;
+    uint64_t val64 = ((uint64_t)val << 32) | val;
+
+    do {
+        d[0] = val64;
+        d[1] = val64;
+        d[2] = val64;
+        d[3] = val64;
+        d += 4;
+    } while(--len);
+#endif
+
+    return dest;
+}
+
+// Set 32 bytes (one cache line) of 0 at a time
+// Len is (# of total bytes/32), so it's "# of 32 Bytes"
+// Same line allocation as memset_64bit_32Bytes_movca
+// Destination must be 32-byte aligned
+void * memset_zeroes_64bit_32Bytes_movca(void *dest, size_t len) {
+    if(!len)
+        return dest;
+
+#ifdef MEMFUNCS_SH4_ASM
+    uint32_t * d = (uint32_t*)dest;
+
+    uint32_t fpscr = memfuncs_fpu_single();
+    __asm__ volatile (
+        "fldi0 fr0\n\t"
+        "fldi0 fr1\n\t"
+        "fschg\n\t" // Switch to pair move mode (FE)
+        "clrs\n" // Align for parallelism (CO) - SH4a use "stc SR, Rn" instead with a dummy Rn
+        ".align 2\n"
+        "1:\n\t"
+        "movca.l %[zero], @%[out]\n\t" // Allocate the line and clear its first 4 bytes (LS)
+        "add #32, %[out]\n\t" // (EX)
+        "dt %[size]\n\t" // (--len) ? 0 -> T : 1 -> T (EX)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "fmov.d DR0, @-%[out]\n\t" // (LS)
+        "bf.s 1b\n\t" // (BR)
+        " add #32, %[out]\n\t" // (EX)
+        "fschg\n" // Switch back to single move mode (FE)
+        : [out] "+&r" ((uint32_t)d), [size] "+&r" (len) // outputs
+        : [zero] "z" (0) // inputs
+        : "t", "fr0", "fr1", "memory" // clobbers
+    );
+    memfuncs_fpu_restore(fpscr);
+#else
+    uint64_t * d = (uint64_t*)dest;
+
+    do {
+        d[0] = 0;
+        d[1] = 0;
+        d[2] = 0;
+        d[3] = 0;
+        d += 4;
+    } while(--len);
+#endif
+
+    return dest;
+}
+
+// Smallest fill worth aligning to a cache line and allocating lines for
+#define MOOP_MOVCA_MIN 128
+
 void * memset_moop(void *dest, const uint32_t val, size_t numbytes) {
     if (numbytes == 0)
         return dest;
@@ -184,8 +340,37 @@ void * memset_moop(void *dest, const uint32_t val, size_t numbytes) {
     uint32_t offset = 0;
 
     if(val) {
+        // Large fill: step up to a cache line boundary, then claim lines
+        if(numbytes >= MOOP_MOVCA_MIN) {
+            offset = -(uintptr_t)dest & 0x03;
+            if(offset) {
+                memset_8bit(dest, val, offset);
+                dest = (char *)dest + offset;
+                numbytes -= offset;
+            }
+
+            offset = -(uintptr_t)dest & 0x1f;
+            if(offset) {
+                memset_32bit(dest, val, offset >> 2);
+                dest = (char *)dest + offset;
+                numbytes -= offset;
+            }
+
+            memset_64bit_32Bytes_movca(dest, val, numbytes >> 5);
+            offset = numbytes & -32;
+            dest = (char *)dest + offset;
+            numbytes &= 31; // clear the last 5 bits
+
+            if(numbytes >= 8)
+                goto eightbytes;
+            else if(numbytes >= 4)
+                goto fourbytes;
+            else if(numbytes)
+                goto singlebytes;
+        }
         // Check 8-byte alignment for 8-byte copy
-        if(!((uintptr_t)dest & 0x07) && numbytes >= 8) {
+        else if(!((uintptr_t)dest & 0x07) && numbytes >= 8) {
+eightbytes:
             memset_64bit(dest, val, numbytes >> 3);
             offset = numbytes & -8;
             dest = (char *)dest + offset;
@@ -221,8 +406,37 @@ singlebytes:
         } 
     }
     else {
+        // Large fill: step up to a cache line boundary, then claim lines
+        if(numbytes >= MOOP_MOVCA_MIN) {
+            offset = -(uintptr_t)dest & 0x03;
+            if(offset) {
+                memset_8bit(dest, 0, offset);
+                dest = (char *)dest + offset;
+                numbytes -= offset;
+            }
+
+            offset = -(uintptr_t)dest & 0x1f;
+            if(offset) {
+                memset_zeroes_32bit(dest, offset >> 2);
+                dest = (char *)dest + offset;
+                numbytes -= offset;
+            }
+
+            memset_zeroes_64bit_32Bytes_movca(dest, numbytes >> 5);
+            offset = numbytes & -32;
+            dest = (char *)dest + offset;
+            numbytes &= 31; // clear the last 5 bits
+
+            if(numbytes >= 8)
+                goto eightbyteszeros;
+            else if(numbytes >= 4)
+                goto fourbyteszeros;
+            else if(numbytes)
+                goto singlebyteszeros;
+        }
         // Check 8-byte alignment for 8-byte copy
-        if(!((uintptr_t)dest & 0x07) && numbytes >= 8) {
+        else if(!((uintptr_t)dest & 0x07) && numbytes >= 8) {
+eightbyteszeros:
             memset_zeroes_64bit(dest, numbytes >> 3);
             offset = numbytes & -8;
             dest = (char *)dest + offset;
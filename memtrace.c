@@ -0,0 +1,415 @@
+// Call-site tracing of the memory functions
+//
+// See memtrace.h for how to hook it in. Built normally this file provides the
+// __wrap_ functions for -Wl,--wrap; built with -DMEMTRACE_PRELOAD (and -fPIC
+// -shared) it defines memcpy, memmove and memset themselves instead and finds
+// the real ones with dlsym(RTLD_NEXT, ...).
+//
+// The __real_ references are weak, so only the functions actually named in
+// --wrap options need to exist; the others are never called.
+
+#ifdef MEMTRACE_PRELOAD
+#define _GNU_SOURCE // RTLD_NEXT
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef _arch_dreamcast
+#include <kos.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef MEMTRACE_PRELOAD
+#include <dlfcn.h>
+#endif
+
+#include "memfuncs.h"
+#include "memtrace.h"
+
+#define MEMTRACE_DEFAULT_OUTPUT "memtrace.dist"
+
+// Largest weight written, so the counts fit replay's unsigned weights
+#define MEMTRACE_MAX_WEIGHT 1000000.0
+
+typedef enum {
+    MEMTRACE_MEMCPY,
+    MEMTRACE_MEMMOVE,
+    MEMTRACE_MEMSET,
+    MEMTRACE_MEMCPY_MOOP,
+    MEMTRACE_MEMMOVE_MOOP,
+    MEMTRACE_MEMSET_MOOP,
+    MEMTRACE_FUNCS
+} memtrace_func;
+
+static const char * const memtrace_names[MEMTRACE_FUNCS] = {
+    "memcpy", "memmove", "memset", "memcpy_moop", "memmove_moop", "memset_moop",
+};
+
+// Operation as "membench replay" names it, by memtrace_func % 3
+static const char * const memtrace_ops[] = { "memcpy", "memmove", "memset" };
+
+typedef struct {
+    uintptr_t pc; // return address of the call, 0 for a free slot
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t ns;
+    uint64_t sizes[MEMTRACE_SIZE_BUCKETS];
+    uint64_t src_align[MEMTRACE_ALIGN_CLASSES]; // unused for memset
+    uint64_t dst_align[MEMTRACE_ALIGN_CLASSES];
+} memtrace_site;
+
+static memtrace_site memtrace_sites[MEMTRACE_FUNCS][MEMTRACE_SITES];
+static uint64_t memtrace_dropped;
+static int memtrace_paused; // set while dumping or resetting, read by every traced call
+
+#ifdef _arch_dreamcast
+#define MEMTRACE_ADD(p, v) (*(p) += (v))
+#define MEMTRACE_LOAD(p) (*(p))
+#define MEMTRACE_STORE(p, v) (*(p) = (v))
+#define MEMTRACE_CLAIM(p, pc) (!*(p) ? (*(p) = (pc), 1) : 0)
+#else
+#define MEMTRACE_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#define MEMTRACE_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define MEMTRACE_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+static inline int memtrace_claim(uintptr_t *p, uintptr_t pc) {
+    uintptr_t expected = 0;
+
+    return __atomic_compare_exchange_n(p, &expected, pc, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+#define MEMTRACE_CLAIM(p, pc) memtrace_claim((p), (pc))
+#endif
+
+static inline uint64_t memtrace_now(void) {
+#if defined(MEMTRACE_NO_TIME)
+    return 0;
+#elif defined(_arch_dreamcast)
+    return timer_ns_gettime64();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline unsigned memtrace_size_bucket(size_t numbytes) {
+    if(numbytes >= (size_t)1 << 31)
+        return MEMTRACE_SIZE_BUCKETS - 1;
+
+    return numbytes ? 32 - __builtin_clz((uint32_t)numbytes) : 0;
+}
+
+// Lowest set bit of the address within a 32-byte line
+static inline unsigned memtrace_align_class(const void *p) {
+    unsigned offset = (unsigned)((uintptr_t)p & 31);
+
+    return offset ? (unsigned)__builtin_ctz(offset) : MEMTRACE_ALIGN_CLASSES - 1;
+}
+
+// Open addressing on the return address, linear probing
+static memtrace_site * memtrace_find(memtrace_func func, uintptr_t pc) {
+    unsigned slot = (unsigned)(pc >> 1) * 2654435761u % MEMTRACE_SITES;
+    unsigned i;
+
+    for(i = 0; i < MEMTRACE_SITES; i++) {
+        memtrace_site *site = &memtrace_sites[func][(slot + i) % MEMTRACE_SITES];
+        uintptr_t owner = MEMTRACE_LOAD(&site->pc);
+
+        if(owner == pc)
+            return site;
+
+        // Another thread may have claimed it for the same pc in between
+        if(!owner && (MEMTRACE_CLAIM(&site->pc, pc) || MEMTRACE_LOAD(&site->pc) == pc))
+            return site;
+    }
+
+    MEMTRACE_ADD(&memtrace_dropped, 1);
+    return NULL;
+}
+
+static void memtrace_record(memtrace_func func, uintptr_t pc, const void *dest, const void *src,
+    size_t numbytes, uint64_t ns) {
+    memtrace_site *site;
+
+    if(MEMTRACE_LOAD(&memtrace_paused) || !(site = memtrace_find(func, pc)))
+        return;
+
+    MEMTRACE_ADD(&site->calls, 1);
+    MEMTRACE_ADD(&site->bytes, numbytes);
+    MEMTRACE_ADD(&site->ns, ns);
+    MEMTRACE_ADD(&site->sizes[memtrace_size_bucket(numbytes)], 1);
+    MEMTRACE_ADD(&site->dst_align[memtrace_align_class(dest)], 1);
+    if(src)
+        MEMTRACE_ADD(&site->src_align[memtrace_align_class(src)], 1);
+}
+
+// Body of every traced function: time the real call and record it against
+// the caller's return address
+#define MEMTRACE_CALL(func, dest, src, numbytes, call) \
+    uint64_t start = memtrace_now(); \
+    void *ret = (call); \
+    memtrace_record((func), (uintptr_t)__builtin_return_address(0), (dest), (src), (numbytes), memtrace_now() - start); \
+    return ret;
+
+#ifndef MEMTRACE_PRELOAD
+
+extern void * __real_memcpy(void *dest, const void *src, size_t numbytes) __attribute__((weak));
+extern void * __real_memmove(void *dest, const void *src, size_t numbytes) __attribute__((weak));
+extern void * __real_memset(void *dest, int val, size_t numbytes) __attribute__((weak));
+extern void * __real_memcpy_moop(void *dest, const void *src, size_t numbytes) __attribute__((weak));
+extern void * __real_memmove_moop(void *dest, const void *src, size_t numbytes) __attribute__((weak));
+extern void * __real_memset_moop(void *dest, const uint32_t val, size_t numbytes) __attribute__((weak));
+
+void * __wrap_memcpy(void *dest, const void *src, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMCPY, dest, src, numbytes, __real_memcpy(dest, src, numbytes))
+}
+
+void * __wrap_memmove(void *dest, const void *src, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMMOVE, dest, src, numbytes, __real_memmove(dest, src, numbytes))
+}
+
+void * __wrap_memset(void *dest, int val, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMSET, dest, NULL, numbytes, __real_memset(dest, val, numbytes))
+}
+
+void * __wrap_memcpy_moop(void *dest, const void *src, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMCPY_MOOP, dest, src, numbytes, __real_memcpy_moop(dest, src, numbytes))
+}
+
+void * __wrap_memmove_moop(void *dest, const void *src, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMMOVE_MOOP, dest, src, numbytes, __real_memmove_moop(dest, src, numbytes))
+}
+
+void * __wrap_memset_moop(void *dest, const uint32_t val, size_t numbytes) {
+    MEMTRACE_CALL(MEMTRACE_MEMSET_MOOP, dest, NULL, numbytes, __real_memset_moop(dest, val, numbytes))
+}
+
+#else
+
+typedef void * (*memtrace_copy_fn)(void *dest, const void *src, size_t numbytes);
+typedef void * (*memtrace_set_fn)(void *dest, int val, size_t numbytes);
+
+static memtrace_copy_fn real_memcpy, real_memmove;
+static memtrace_set_fn real_memset;
+static int memtrace_resolving;
+
+// Stand-ins for the calls dlsym itself makes before the real functions are
+// known. Build with -fno-builtin -fno-tree-loop-distribute-patterns, or these
+// loops turn back into calls to themselves.
+static void * memtrace_byte_move(void *dest, const void *src, size_t numbytes) {
+    uint8_t *d = dest;
+    const uint8_t *s = src;
+
+    if(d < s) {
+        while(numbytes--)
+            *d++ = *s++;
+    }
+    else {
+        while(numbytes--)
+            d[numbytes] = s[numbytes];
+    }
+
+    return dest;
+}
+
+static void * memtrace_byte_set(void *dest, int val, size_t numbytes) {
+    uint8_t *d = dest;
+
+    while(numbytes--)
+        *d++ = (uint8_t)val;
+
+    return dest;
+}
+
+// Returns 0 while the lookup is in progress, i.e. when called from dlsym
+static int memtrace_resolve(void) {
+    if(real_memcpy && real_memmove && real_memset)
+        return 1;
+    if(memtrace_resolving)
+        return 0;
+
+    memtrace_resolving = 1;
+    real_memcpy = (memtrace_copy_fn)dlsym(RTLD_NEXT, "memcpy");
+    real_memmove = (memtrace_copy_fn)dlsym(RTLD_NEXT, "memmove");
+    real_memset = (memtrace_set_fn)dlsym(RTLD_NEXT, "memset");
+    memtrace_resolving = 0;
+
+    if(!real_memcpy || !real_memmove || !real_memset) {
+        fprintf(stderr, "memtrace: can't find the libc memory functions\n");
+        abort();
+    }
+
+    return 1;
+}
+
+void * memcpy(void *dest, const void *src, size_t numbytes) {
+    if(!memtrace_resolve())
+        return memtrace_byte_move(dest, src, numbytes);
+
+    MEMTRACE_CALL(MEMTRACE_MEMCPY, dest, src, numbytes, real_memcpy(dest, src, numbytes))
+}
+
+void * memmove(void *dest, const void *src, size_t numbytes) {
+    if(!memtrace_resolve())
+        return memtrace_byte_move(dest, src, numbytes);
+
+    MEMTRACE_CALL(MEMTRACE_MEMMOVE, dest, src, numbytes, real_memmove(dest, src, numbytes))
+}
+
+void * memset(void *dest, int val, size_t numbytes) {
+    if(!memtrace_resolve())
+        return memtrace_byte_set(dest, val, numbytes);
+
+    MEMTRACE_CALL(MEMTRACE_MEMSET, dest, NULL, numbytes, real_memset(dest, val, numbytes))
+}
+
+#endif
+
+// Offset from a 32-byte boundary that has the alignment of class c
+static unsigned memtrace_offset(unsigned c) {
+    return c < MEMTRACE_ALIGN_CLASSES - 1 ? 1u << c : 0;
+}
+
+// Sizes and alignments are recorded separately, so each (size, src, dst)
+// combination gets the size bucket's count split by the alignment shares.
+void memtrace_dump(FILE *f) {
+    uint64_t calls = 0, largest = 1;
+    unsigned func, i, k, s, d, sites = 0;
+    double scale;
+
+    MEMTRACE_STORE(&memtrace_paused, 1);
+
+    for(func = 0; func < MEMTRACE_FUNCS; func++) {
+        for(i = 0; i < MEMTRACE_SITES; i++) {
+            const memtrace_site *site = &memtrace_sites[func][i];
+
+            if(!site->calls)
+                continue;
+
+            sites++;
+            calls += site->calls;
+            for(k = 0; k < MEMTRACE_SIZE_BUCKETS; k++) {
+                if(site->sizes[k] > largest)
+                    largest = site->sizes[k];
+            }
+        }
+    }
+
+    scale = largest > MEMTRACE_MAX_WEIGHT ? MEMTRACE_MAX_WEIGHT / (double)largest : 1.0;
+
+    fprintf(f, "# Generated by memtrace: %llu calls from %u call sites", (unsigned long long)calls, sites);
+    if(memtrace_dropped)
+        fprintf(f, ", %llu more from sites past MEMTRACE_SITES not recorded", (unsigned long long)memtrace_dropped);
+    fprintf(f, "\n# Replay with \"membench replay FILE\".\n");
+
+    for(func = 0; func < MEMTRACE_FUNCS; func++) {
+        const char *op = memtrace_ops[func % 3];
+        int is_set = func % 3 == MEMTRACE_MEMSET;
+
+        for(i = 0; i < MEMTRACE_SITES; i++) {
+            const memtrace_site *site = &memtrace_sites[func][i];
+
+            if(!site->calls)
+                continue;
+
+            fprintf(f, "\n# %s from %p: %llu calls, %llu bytes, %llu ns\n", memtrace_names[func], (void *)site->pc,
+                (unsigned long long)site->calls, (unsigned long long)site->bytes, (unsigned long long)site->ns);
+
+            for(k = 0; k < MEMTRACE_SIZE_BUCKETS; k++) {
+                unsigned long lo = k ? 1ul << (k - 1) : 0;
+                unsigned long hi = k && k < MEMTRACE_SIZE_BUCKETS - 1 ? 2 * lo - 1 : lo;
+                char range[32];
+
+                if(!site->sizes[k])
+                    continue;
+
+                if(hi > lo)
+                    snprintf(range, sizeof(range), "%lu-%lu", lo, hi);
+                else
+                    snprintf(range, sizeof(range), "%lu", lo);
+
+                // memset has no source alignment, one pass over dst is enough
+                for(s = 0; s < (is_set ? 1u : MEMTRACE_ALIGN_CLASSES); s++) {
+                    if(!is_set && !site->src_align[s])
+                        continue;
+
+                    for(d = 0; d < MEMTRACE_ALIGN_CLASSES; d++) {
+                        double share = (double)site->dst_align[d] / site->calls;
+                        unsigned long weight;
+
+                        if(!is_set)
+                            share *= (double)site->src_align[s] / site->calls;
+
+                        weight = (unsigned long)((double)site->sizes[k] * share * scale + 0.5);
+                        if(!weight)
+                            continue;
+
+                        if(is_set)
+                            fprintf(f, "%s %s %u %lu\n", op, range, memtrace_offset(d), weight);
+                        else
+                            fprintf(f, "%s %s %u:%u %lu\n", op, range, memtrace_offset(s), memtrace_offset(d), weight);
+                    }
+                }
+            }
+        }
+    }
+
+    MEMTRACE_STORE(&memtrace_paused, 0);
+}
+
+int memtrace_write(const char *path) {
+    FILE *f;
+
+    MEMTRACE_STORE(&memtrace_paused, 1);
+    f = fopen(path, "w");
+    if(!f) {
+        MEMTRACE_STORE(&memtrace_paused, 0);
+        return -1;
+    }
+
+    memtrace_dump(f);
+    MEMTRACE_STORE(&memtrace_paused, 1);
+    fclose(f);
+    MEMTRACE_STORE(&memtrace_paused, 0);
+    return 0;
+}
+
+void memtrace_reset(void) {
+    unsigned func, i, k;
+
+    MEMTRACE_STORE(&memtrace_paused, 1);
+
+    for(func = 0; func < MEMTRACE_FUNCS; func++) {
+        for(i = 0; i < MEMTRACE_SITES; i++) {
+            memtrace_site *site = &memtrace_sites[func][i];
+
+            site->pc = 0;
+            site->calls = site->bytes = site->ns = 0;
+            for(k = 0; k < MEMTRACE_SIZE_BUCKETS; k++)
+                site->sizes[k] = 0;
+            for(k = 0; k < MEMTRACE_ALIGN_CLASSES; k++)
+                site->src_align[k] = site->dst_align[k] = 0;
+        }
+    }
+
+    memtrace_dropped = 0;
+    MEMTRACE_STORE(&memtrace_paused, 0);
+}
+
+#ifndef _arch_dreamcast
+// Hosted builds write the trace when the program exits
+__attribute__((destructor)) static void memtrace_at_exit(void) {
+    const char *path = getenv("MEMTRACE_OUTPUT");
+
+    if(!path)
+        path = MEMTRACE_DEFAULT_OUTPUT;
+
+    if(memtrace_write(path))
+        fprintf(stderr, "memtrace: can't write %s\n", path);
+}
+#endif
@@ -0,0 +1,61 @@
+//==============================================================================
+//  Call-Site Tracing of the Memory Functions
+//==============================================================================
+//
+// Records, per call site and function, how often memcpy/memmove/memset and
+// their *_moop versions are called, a log2 histogram of the sizes, the
+// alignment of the source and destination, and the total bytes and time. The
+// result is written in the distribution format "membench replay" reads, so an
+// application's real call mix can be benchmarked directly.
+//
+// Three ways to hook it into an application:
+//
+//   Link-time wrapping (any GNU ld target, including KallistiOS): link
+//   memtrace.c in and add -Wl,--wrap=SYMBOL for each function to trace, e.g.
+//     -Wl,--wrap=memcpy_moop,--wrap=memset_moop,--wrap=memcpy
+//   Calls from other object files then go through the __wrap_ functions here.
+//   Build the application with -fno-builtin or the compiler will inline
+//   small libc calls before the linker ever sees them.
+//
+//   LD_PRELOAD (hosted Linux, libc functions only): "make trace-host" builds
+//   build/host/libmemtrace.so, and
+//     LD_PRELOAD=build/host/libmemtrace.so MEMTRACE_OUTPUT=app.dist ./app
+//   writes app.dist when the program exits.
+//
+//   Either way on a hosted build, the trace is written at exit to the file in
+//   MEMTRACE_OUTPUT (default memtrace.dist). On KallistiOS call memtrace_write()
+//   yourself, e.g. memtrace_write("/pc/app.dist") before returning from main.
+//
+// Overhead is a hash lookup on the return address and a few counter updates
+// per call, plus two clock reads unless built with -DMEMTRACE_NO_TIME. Hosted
+// builds update the counters atomically; the KallistiOS build assumes calls
+// don't race, since SH4 has no cheap atomics.
+//
+
+#ifndef __MEMTRACE_H_
+#define __MEMTRACE_H_
+
+#include <stdio.h>
+
+// Distinct call sites kept per function; calls from further sites are only
+// counted as dropped
+#ifndef MEMTRACE_SITES
+#define MEMTRACE_SITES 128
+#endif
+
+// Bucket 0 is size 0, bucket k covers [2^(k-1), 2^k) like memauto_bucket(),
+// the last one everything from 2^31 up
+#define MEMTRACE_SIZE_BUCKETS 33
+
+// Lowest set address bit 0..4, or 32-byte aligned
+#define MEMTRACE_ALIGN_CLASSES 6
+
+// Write the trace as a replay distribution. Returns 0, or -1 if the file
+// can't be opened. Tracing is paused while writing.
+int memtrace_write(const char *path);
+void memtrace_dump(FILE *f);
+
+// Forget everything recorded so far
+void memtrace_reset(void);
+
+#endif /* __MEMTRACE_H_ */
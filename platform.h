@@ -0,0 +1,38 @@
+//==============================================================================
+//  Benchmark Platform Layer
+//==============================================================================
+//
+// Everything bench.c needs from the environment it runs on. There is one
+// implementation per target:
+//
+//   platform_kos.c   - Dreamcast under KallistiOS (timer_ns_gettime64)
+//   platform_posix.c - hosted Linux, native or SH4 under qemu-sh4
+//                      (clock_gettime, or rdtsc with PLATFORM_TIMER_RDTSC)
+//
+// The Makefile links exactly one of them.
+//
+
+#ifndef __PLATFORM_H_
+#define __PLATFORM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Call once before any other platform_* function.
+void platform_init(void);
+
+// Monotonic time in nanoseconds. Only differences are meaningful.
+uint64_t platform_time_ns(void);
+
+// CPU clock in MHz for converting times to cycles, 0 if unknown.
+double platform_cpu_mhz(void);
+
+// Write back and drop the data cache lines covering [p, p + len), so the next
+// access to them goes to memory. Where single lines can't be targeted the
+// whole cache is evicted instead, so this can be much slower than len implies.
+void platform_cache_purge(const void *p, size_t len);
+
+// Short human-readable name of the platform and timer, e.g. "kos".
+const char * platform_name(void);
+
+#endif /* __PLATFORM_H_ */
@@ -0,0 +1,31 @@
+// Dreamcast / KallistiOS platform layer
+
+#include <kos.h>
+
+#include "platform.h"
+
+void platform_init(void) {
+}
+
+uint64_t platform_time_ns(void) {
+    return timer_ns_gettime64();
+}
+
+// SH7750 core clock on the Dreamcast
+double platform_cpu_mhz(void) {
+    return 200.0;
+}
+
+// ocbp writes a dirty line back before invalidating it. ocbi would be cheaper
+// but drops the data, and the bench checks the buffers afterwards.
+void platform_cache_purge(const void *p, size_t len) {
+    uintptr_t line = (uintptr_t)p & ~(uintptr_t)31;
+    uintptr_t end = (uintptr_t)p + len;
+
+    for(; line < end; line += 32)
+        __asm__ volatile ("ocbp @%0\n" : : "r" (line) : "memory");
+}
+
+const char * platform_name(void) {
+    return "kos";
+}
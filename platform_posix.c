@@ -0,0 +1,133 @@
+// Hosted Linux platform layer (native builds and SH4 under qemu-sh4)
+//
+// Uses clock_gettime(CLOCK_MONOTONIC) by default. Define PLATFORM_TIMER_RDTSC
+// on x86 to read the TSC instead; its rate is calibrated against the monotonic
+// clock in platform_init().
+//
+// platform_cache_purge() uses ocbp on SH4. Elsewhere there is no portable way
+// to drop single lines, so it reads and writes an eviction buffer larger than
+// the last-level cache (PLATFORM_EVICT_SIZE bytes, 32 MB by default).
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "platform.h"
+
+#if defined(PLATFORM_TIMER_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define USE_RDTSC 1
+#endif
+
+#ifndef PLATFORM_EVICT_SIZE
+#define PLATFORM_EVICT_SIZE (32u << 20)
+#endif
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef USE_RDTSC
+static double ns_per_tick = 1.0;
+
+void platform_init(void) {
+    // Spin for ~20 ms and compare the two clocks
+    uint64_t ns_start = clock_ns();
+    uint64_t tsc_start = __rdtsc();
+    uint64_t ns_end;
+
+    do {
+        ns_end = clock_ns();
+    } while(ns_end - ns_start < 20000000ull);
+
+    ns_per_tick = (double)(ns_end - ns_start) / (double)(__rdtsc() - tsc_start);
+}
+
+uint64_t platform_time_ns(void) {
+    return (uint64_t)((double)__rdtsc() * ns_per_tick);
+}
+
+const char * platform_name(void) {
+    return "posix-rdtsc";
+}
+#else
+void platform_init(void) {
+}
+
+uint64_t platform_time_ns(void) {
+    return clock_ns();
+}
+
+const char * platform_name(void) {
+    return "posix";
+}
+#endif
+
+// Clock rate for cycle counts: PLATFORM_CPU_MHZ if defined, else the TSC rate
+// with PLATFORM_TIMER_RDTSC, else the first "cpu MHz" line of /proc/cpuinfo
+// (which qemu-sh4 doesn't have, so define it there)
+double platform_cpu_mhz(void) {
+#if defined(PLATFORM_CPU_MHZ)
+    return PLATFORM_CPU_MHZ;
+#elif defined(USE_RDTSC)
+    return 1000.0 / ns_per_tick;
+#else
+    static double mhz = -1;
+    char line[256];
+    FILE *f;
+
+    if(mhz >= 0)
+        return mhz;
+
+    mhz = 0;
+    f = fopen("/proc/cpuinfo", "r");
+    if(!f)
+        return mhz;
+
+    while(fgets(line, sizeof(line), f)) {
+        if(sscanf(line, "cpu MHz : %lf", &mhz) == 1)
+            break;
+    }
+
+    fclose(f);
+    return mhz;
+#endif
+}
+
+#if defined(__sh__) || defined(__SH4__)
+// Write back and invalidate, see platform_kos.c
+void platform_cache_purge(const void *p, size_t len) {
+    uintptr_t line = (uintptr_t)p & ~(uintptr_t)31;
+    uintptr_t end = (uintptr_t)p + len;
+
+    for(; line < end; line += 32)
+        __asm__ volatile ("ocbp @%0\n" : : "r" (line) : "memory");
+}
+#else
+static volatile uint8_t *evict_buf;
+
+void platform_cache_purge(const void *p, size_t len) {
+    size_t i;
+
+    (void)p;
+    (void)len;
+
+    if(!evict_buf) {
+        evict_buf = malloc(PLATFORM_EVICT_SIZE);
+        if(!evict_buf) {
+            fprintf(stderr, "platform: out of memory for the eviction buffer\n");
+            abort();
+        }
+    }
+
+    // One write per 64-byte line leaves every line of it dirty, so whatever
+    // was cached before has to go
+    for(i = 0; i < PLATFORM_EVICT_SIZE; i += 64)
+        evict_buf[i]++;
+}
+#endif